@@ -0,0 +1,174 @@
+#include "alloc_guard.h"
+
+#ifdef HOTWHEELS_CHECK_ALLOC
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <unistd.h>
+
+using namespace std;
+
+// glibc's own entry points, so the interposed versions can forward to them.
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *pointer, size_t size);
+extern "C" void __libc_free(void *pointer);
+extern "C" void *__libc_memalign(size_t alignment, size_t size);
+
+namespace
+{
+    thread_local const char *tWindow = nullptr;
+    atomic<uint64_t> gWindows{0};
+
+    // Reports with write(2): stdio could allocate, and we are already inside the allocator.
+    void WriteText(const char *text)
+    {
+        ssize_t ignored = write(STDERR_FILENO, text, strlen(text));
+        (void)ignored;
+    }
+
+    void Check(const char *allocator)
+    {
+        if (!tWindow)
+            return;
+        const char *window = tWindow;
+        tWindow = nullptr;
+        WriteText("[AllocGuard] ");
+        WriteText(allocator);
+        WriteText(" called inside hot path window '");
+        WriteText(window);
+        WriteText("'\n");
+        abort();
+    }
+}
+
+void AllocGuardBegin(const char *window)
+{
+    tWindow = window;
+    gWindows.fetch_add(1, memory_order_relaxed);
+}
+
+void AllocGuardEnd()
+{
+    tWindow = nullptr;
+}
+
+void AllocGuardReport()
+{
+    printf("[AllocGuard] %llu hot path windows ran without allocating.\n", (unsigned long long)gWindows.load());
+}
+
+// === INTERPOSED ALLOCATORS ===
+extern "C" void *malloc(size_t size)
+{
+    Check("malloc");
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    Check("calloc");
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size)
+{
+    Check("realloc");
+    return __libc_realloc(pointer, size);
+}
+
+extern "C" void *memalign(size_t alignment, size_t size)
+{
+    Check("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size)
+{
+    Check("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void **pointer, size_t alignment, size_t size)
+{
+    Check("posix_memalign");
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+    void *result = __libc_memalign(alignment, size);
+    if (!result)
+        return ENOMEM;
+    *pointer = result;
+    return 0;
+}
+
+void *operator new(size_t size)
+{
+    Check("operator new");
+    if (void *pointer = __libc_malloc(size ? size : 1))
+        return pointer;
+    throw bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    Check("operator new[]");
+    if (void *pointer = __libc_malloc(size ? size : 1))
+        return pointer;
+    throw bad_alloc();
+}
+
+void *operator new(size_t size, const nothrow_t &) noexcept
+{
+    Check("operator new");
+    return __libc_malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const nothrow_t &) noexcept
+{
+    Check("operator new[]");
+    return __libc_malloc(size ? size : 1);
+}
+
+// Over-aligned types, e.g. the alignas(64) RigStats.
+void *operator new(size_t size, align_val_t alignment)
+{
+    Check("operator new");
+    if (void *pointer = __libc_memalign(static_cast<size_t>(alignment), size ? size : 1))
+        return pointer;
+    throw bad_alloc();
+}
+
+void *operator new[](size_t size, align_val_t alignment)
+{
+    Check("operator new[]");
+    if (void *pointer = __libc_memalign(static_cast<size_t>(alignment), size ? size : 1))
+        return pointer;
+    throw bad_alloc();
+}
+
+void *operator new(size_t size, align_val_t alignment, const nothrow_t &) noexcept
+{
+    Check("operator new");
+    return __libc_memalign(static_cast<size_t>(alignment), size ? size : 1);
+}
+
+void *operator new[](size_t size, align_val_t alignment, const nothrow_t &) noexcept
+{
+    Check("operator new[]");
+    return __libc_memalign(static_cast<size_t>(alignment), size ? size : 1);
+}
+
+void operator delete(void *pointer) noexcept { __libc_free(pointer); }
+void operator delete[](void *pointer) noexcept { __libc_free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { __libc_free(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { __libc_free(pointer); }
+void operator delete(void *pointer, align_val_t) noexcept { __libc_free(pointer); }
+void operator delete[](void *pointer, align_val_t) noexcept { __libc_free(pointer); }
+void operator delete(void *pointer, size_t, align_val_t) noexcept { __libc_free(pointer); }
+void operator delete[](void *pointer, size_t, align_val_t) noexcept { __libc_free(pointer); }
+
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+
+// === ALLOCATION GUARD ===
+// Check build for the launch hot path. Built with -DHOTWHEELS_CHECK_ALLOC,
+// malloc/calloc/realloc, the aligned allocators and global operator new
+// (aligned included) are interposed and any allocation made by a thread inside
+// a HOT_PATH window prints the window name and aborts. Run the simulator
+// (hotwheels-sim --simulate N) in that build to exercise every window; ctest
+// does so through hotwheels-sim-alloc-check. Otherwise the macros expand to nothing.
+//
+//   HOT_PATH_BEGIN("sensor1_to_catcher");
+//   ...                                  // must not allocate
+//   HOT_PATH_END();
+//
+// Window names must be string literals.
+
+#ifdef HOTWHEELS_CHECK_ALLOC
+
+void AllocGuardBegin(const char *window);
+void AllocGuardEnd();
+void AllocGuardReport(); // prints how many windows ran clean
+
+#define HOT_PATH_BEGIN(name) AllocGuardBegin(name)
+#define HOT_PATH_END() AllocGuardEnd()
+
+#else
+
+#define HOT_PATH_BEGIN(name) ((void)0)
+#define HOT_PATH_END() ((void)0)
+inline void AllocGuardReport() {}
+
+#endif
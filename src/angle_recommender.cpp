@@ -0,0 +1,158 @@
+#include "angle_recommender.h"
+#include "params.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace
+{
+    double NormalCdf(double z)
+    {
+        return 0.5 * erfc(-z / M_SQRT2);
+    }
+
+    bool Trusted(const SpeedPriors &priors, int bin)
+    {
+        return priors.bins[bin].count >= RECOMMEND_MIN_LAUNCHES;
+    }
+
+    double MarginScore(const AngleScore &score)
+    {
+        return min(score.timingMargin / RECOMMEND_TIMING_SCALE, score.positionMargin / RECOMMEND_POSITION_SCALE);
+    }
+}
+
+bool InterpolateSpeed(const SpeedPriors &priors, double angle, double &mean, double &stddev)
+{
+    double x = angle / PRIOR_BIN_DEG;
+    if (x < 0.0 || x > PRIOR_BINS - 1)
+        return false;
+    int below = static_cast<int>(floor(x));
+    int above = static_cast<int>(ceil(x));
+    while (below >= 0 && !Trusted(priors, below))
+        below--;
+    while (above < PRIOR_BINS && !Trusted(priors, above))
+        above++;
+    if (below < 0 || above >= PRIOR_BINS || (above - below) * PRIOR_BIN_DEG > RECOMMEND_MAX_GAP_DEG)
+        return false;
+
+    const AnglePrior &low = priors.bins[below];
+    const AnglePrior &high = priors.bins[above];
+    double t = (above == below) ? 0.0 : (x - below) / (above - below);
+    mean = low.meanSpeed + t * (high.meanSpeed - low.meanSpeed);
+    stddev = max(low.speedStdDev + t * (high.speedStdDev - low.speedStdDev), RECOMMEND_MIN_SPEED_STDDEV);
+    return true;
+}
+
+AngleScore ScoreAngle(double angle, double mean, double stddev, double catcherStart, double commandDelay,
+                      const LaunchParams &params)
+{
+    AngleScore score;
+    score.angle = angle;
+    score.speed = mean;
+    score.speedStdDev = stddev;
+    score.timingMargin = numeric_limits<double>::infinity();
+    score.positionMargin = numeric_limits<double>::infinity();
+
+    // Each speed sample stands for the probability mass up to halfway to its
+    // neighbours; the outermost ones take the tails.
+    double step = 2.0 * RECOMMEND_SPEED_SIGMAS / (RECOMMEND_SPEED_SAMPLES - 1);
+    for (int i = 0; i < RECOMMEND_SPEED_SAMPLES; i++)
+    {
+        double z = -RECOMMEND_SPEED_SIGMAS + i * step;
+        double speed = mean + z * stddev;
+        if (speed <= 0.0)
+            continue;
+
+        double landing = ComputeLandingPosition(speed, angle, params.rampHeight);
+        double positionMargin = min(landing - params.minCatcherPosition, params.maxCatcherPosition - landing);
+        double target = clamp(landing, params.minCatcherPosition, params.maxCatcherPosition);
+        double timingMargin = ComputeTimeOfFlight(speed, angle, params.rampHeight) -
+                              (commandDelay + ComputeMoveTime(params.profiles[CATCHER], target - catcherStart));
+
+        if (positionMargin >= 0.0 && timingMargin >= 0.0)
+        {
+            double lower = (i == 0) ? 0.0 : NormalCdf(z - step / 2.0);
+            double upper = (i == RECOMMEND_SPEED_SAMPLES - 1) ? 1.0 : NormalCdf(z + step / 2.0);
+            score.catchProbability += upper - lower;
+        }
+        if (fabs(z) <= RECOMMEND_WORST_SIGMAS + 1e-9)
+        {
+            score.timingMargin = min(score.timingMargin, timingMargin);
+            score.positionMargin = min(score.positionMargin, positionMargin);
+        }
+    }
+    return score;
+}
+
+void ScoreAngles(const SpeedPriors &priors, double catcherStart, double commandDelay, const LaunchParams &params,
+                 vector<AngleScore> &scores)
+{
+    scores.clear();
+    int first = 0, last = PRIOR_BINS - 1;
+    while (first < PRIOR_BINS && !Trusted(priors, first))
+        first++;
+    while (last > first && !Trusted(priors, last))
+        last--;
+    if (first == PRIOR_BINS)
+        return;
+
+    double from = first * PRIOR_BIN_DEG;
+    int steps = static_cast<int>(lround((last - first) * PRIOR_BIN_DEG / RECOMMEND_ANGLE_STEP));
+    for (int i = 0; i <= steps; i++)
+    {
+        double angle = from + i * RECOMMEND_ANGLE_STEP;
+        double mean = 0.0, stddev = 0.0;
+        if (InterpolateSpeed(priors, angle, mean, stddev))
+            scores.push_back(ScoreAngle(angle, mean, stddev, catcherStart, commandDelay, params));
+    }
+}
+
+int PickAngle(const vector<AngleScore> &scores)
+{
+    double bestProbability = 0.0;
+    for (const AngleScore &score : scores)
+        bestProbability = max(bestProbability, score.catchProbability);
+
+    int pick = -1;
+    for (int i = 0; i < static_cast<int>(scores.size()); i++)
+    {
+        if (scores[i].catchProbability < bestProbability - RECOMMEND_PROBABILITY_TIE)
+            continue;
+        if (pick < 0 || MarginScore(scores[i]) > MarginScore(scores[pick]))
+            pick = i;
+    }
+    return pick;
+}
+
+// === RECOMMENDER ===
+AngleRecommender::AngleRecommender(const string &historyPath)
+    : paramsReader(ParamsRegisterReader()), priors(LoadSpeedPriors(historyPath))
+{
+}
+
+AngleRecommender::~AngleRecommender()
+{
+    ParamsUnregisterReader(paramsReader);
+}
+
+bool AngleRecommender::Recommend(LaunchIO &io, AngleScore &best)
+{
+    LaunchParams params = ParamsAcquire(paramsReader).launch;
+    ParamsRelease(paramsReader);
+    angleOffset = params.angleOffset;
+    rampHeight = params.rampHeight;
+
+    IoResult<double> catcher = io.AxisActualPosition(CATCHER);
+    if (catcher.error != IO_OK)
+        return false;
+
+    ScoreAngles(priors, catcher.value, RECOMMEND_COMMAND_DELAY, params, scores);
+    int pick = PickAngle(scores);
+    if (pick < 0)
+        return false;
+    best = scores[pick];
+    return true;
+}
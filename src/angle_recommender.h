@@ -0,0 +1,78 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "launch_history.h"
+#include "launch_pipeline.h"
+
+// === ANGLE RECOMMENDER ===
+// Scores a fine grid of ramp angles between launches and picks the one most
+// likely to be caught. For each angle the exit speed is taken as normal with
+// the mean and spread the history store has seen at that angle (interpolated
+// between observed bins, never extrapolated). The landing model, time of
+// flight and catcher move time from the catcher's current position then give,
+// per speed sample, whether the catcher gets there in time and within its
+// travel. The pick has the highest catch probability; near-ties go to the
+// larger worst-case timing/position margin.
+
+constexpr double RECOMMEND_ANGLE_STEP = 0.1;         // deg between grid angles
+constexpr double RECOMMEND_MAX_GAP_DEG = 5.0;        // widest gap between observed bins to interpolate across
+constexpr uint32_t RECOMMEND_MIN_LAUNCHES = 3;       // launches a bin needs before it is trusted
+constexpr double RECOMMEND_MIN_SPEED_STDDEV = 0.01;  // m/s, floor for bins that happen to agree closely
+constexpr int RECOMMEND_SPEED_SAMPLES = 33;          // speed samples per angle, across +/- RECOMMEND_SPEED_SIGMAS
+constexpr double RECOMMEND_SPEED_SIGMAS = 4.0;
+constexpr double RECOMMEND_WORST_SIGMAS = 2.0;       // margins are the worst within +/- this many sigma
+constexpr double RECOMMEND_COMMAND_DELAY = 0.005;    // s, sensor 2 to catcher command, assumed
+constexpr double RECOMMEND_PROBABILITY_TIE = 0.005;  // catch probabilities this close count as equal
+constexpr double RECOMMEND_TIMING_SCALE = 0.1;       // s of timing margin worth ...
+constexpr double RECOMMEND_POSITION_SCALE = 0.1;     // ... this many m of position margin
+
+struct AngleScore
+{
+    double angle = 0.0;            // deg, commanded (after offset)
+    double speed = 0.0;            // m/s, expected
+    double speedStdDev = 0.0;      // m/s
+    double catchProbability = 0.0; // of the launch being in range and on time
+    double timingMargin = 0.0;     // s, worst CatchMargin within RECOMMEND_WORST_SIGMAS
+    double positionMargin = 0.0;   // m, worst distance of the landing inside the catcher travel
+};
+
+// Expected exit speed and spread at `angle`; false where the priors do not cover it.
+bool InterpolateSpeed(const SpeedPriors &priors, double angle, double &mean, double &stddev);
+
+AngleScore ScoreAngle(double angle, double mean, double stddev, double catcherStart, double commandDelay,
+                      const LaunchParams &params);
+
+// Scores every grid angle the priors cover into `scores` (cleared first).
+void ScoreAngles(const SpeedPriors &priors, double catcherStart, double commandDelay, const LaunchParams &params,
+                 std::vector<AngleScore> &scores);
+
+// Index of the recommended angle, -1 if `scores` is empty.
+int PickAngle(const std::vector<AngleScore> &scores);
+
+// Owns a parameter reader, so it follows reloaded motion profiles and
+// geometry; use it from one thread. The priors are read from the history
+// store once, when it is constructed, and then kept up to date by Record().
+class AngleRecommender
+{
+public:
+    explicit AngleRecommender(const std::string &historyPath = HISTORY_PATH);
+    ~AngleRecommender();
+
+    // Reads the catcher position and scores the grid against the priors.
+    // False if no angle has enough history yet.
+    bool Recommend(LaunchIO &io, AngleScore &best);
+
+    // Folds a completed launch into the priors, as the history store appends it.
+    void Record(const LaunchRecord &record) { priors.Add(record.angle, record.speed); }
+
+    const SpeedPriors &Priors() const { return priors; }
+    double AngleOffset() const { return angleOffset; } // operator angle = commanded + offset
+    double RampHeight() const { return rampHeight; }   // m, from the last Recommend()'s snapshot
+
+private:
+    int paramsReader;
+    double angleOffset = 0.0;
+    double rampHeight = RAMP_HEIGHT;
+    SpeedPriors priors;
+    std::vector<AngleScore> scores; // reused between launches
+};
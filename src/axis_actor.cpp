@@ -0,0 +1,345 @@
+#include "axis_actor.h"
+#include "rig.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+using namespace std;
+
+AxisActor::AxisActor(unique_ptr<AxisDriver> driver, bool ampEnabled)
+    : driver(move(driver)), ampEnabled(ampEnabled)
+{
+    eventFd = eventfd(0, EFD_CLOEXEC);
+    if (eventFd < 0)
+        perror("[Axis] eventfd");
+}
+
+AxisActor::~AxisActor()
+{
+    Stop();
+    if (eventFd >= 0)
+        close(eventFd);
+}
+
+void AxisActor::Start(const char *name, int cpu, const RtConfig &rt)
+{
+    string threadName = name;
+    thread = std::thread([this, threadName, cpu, rt]() {
+        pthread_setname_np(pthread_self(), threadName.substr(0, 15).c_str());
+        if (cpu >= 0)
+            PinThisThread(cpu);
+        RtConfig actorRt = rt;
+        actorRt.priority = min(rt.priority + 1, 99);
+        actorRt.prefaultStackKb = min<size_t>(rt.prefaultStackKb, 64);
+        RtSetupThread(actorRt);
+        Run();
+    });
+}
+
+void AxisActor::Stop()
+{
+    if (!thread.joinable())
+        return;
+    stopping.store(true, memory_order_release);
+    Wake();
+    thread.join();
+}
+
+IoError AxisActor::Move(double target, const MotionProfile &profile)
+{
+    IoError error = IO_OK;
+    {
+        lock_guard<mutex> guard(lock);
+        stats.posted++;
+        if (moveFailed)
+        {
+            moveFailed = false;
+            error = IO_AXIS_MOVE;
+        }
+        if (stale.exchange(false, memory_order_acquire))
+            targetKnown = false;
+        if (disabled || disableRequested.load(memory_order_acquire))
+        {
+            stats.rejected++;
+            snprintf(errorText, sizeof(errorText), "axis disabled, move to %g not sent", target);
+            return IO_AXIS_MOVE;
+        }
+        if (targetKnown && target == lastTarget && profile == lastProfile)
+        {
+            stats.redundant++;
+            return error;
+        }
+        Command &back = queue[(head + count - 1 + AXIS_QUEUE_CAPACITY) % AXIS_QUEUE_CAPACITY];
+        if (count > 0 && back.type == COMMAND_MOVE)
+        {
+            // Not started yet: the axis only needs to end up at the latest target.
+            back.target = target;
+            back.profile = profile;
+            stats.coalesced++;
+        }
+        else if (Post(Command{COMMAND_MOVE, target, profile}) == 0)
+        {
+            snprintf(errorText, sizeof(errorText), "command queue full, move to %g not sent", target);
+            return IO_AXIS_MOVE;
+        }
+        targetKnown = true;
+        lastTarget = target;
+        lastProfile = profile;
+    }
+    Wake();
+    return error;
+}
+
+IoError AxisActor::SetAmp(bool enabled)
+{
+    uint64_t ticket;
+    {
+        lock_guard<mutex> guard(lock);
+        stats.posted++;
+        // A drive fault can drop the amp without telling us, so only "off" is
+        // trusted; enabling is always sent.
+        if (!enabled && !ampEnabled)
+        {
+            stats.redundant++;
+            return IO_OK;
+        }
+        if (disabled || disableRequested.load(memory_order_acquire))
+        {
+            stats.rejected++;
+            snprintf(errorText, sizeof(errorText), "axis disabled, amp enable not sent");
+            return IO_AXIS_FAULT;
+        }
+        ticket = Post(Command{COMMAND_AMP, 0.0, {}, enabled});
+        if (ticket == 0)
+        {
+            snprintf(errorText, sizeof(errorText), "command queue full, amp %s not sent", enabled ? "enable" : "disable");
+            return IO_AXIS_FAULT;
+        }
+        ampEnabled = enabled;
+    }
+    Wake();
+    return Wait(ticket, IO_AXIS_FAULT);
+}
+
+IoError AxisActor::ClearFaults()
+{
+    uint64_t ticket;
+    {
+        lock_guard<mutex> guard(lock);
+        stats.posted++;
+        if (disabled || disableRequested.load(memory_order_acquire))
+        {
+            stats.rejected++;
+            snprintf(errorText, sizeof(errorText), "axis disabled, fault clear not sent");
+            return IO_AXIS_FAULT;
+        }
+        ticket = Post(Command{COMMAND_CLEAR_FAULTS});
+        if (ticket == 0)
+        {
+            snprintf(errorText, sizeof(errorText), "command queue full, fault clear not sent");
+            return IO_AXIS_FAULT;
+        }
+        // Clearing drops the command position onto wherever the axis stopped.
+        targetKnown = false;
+    }
+    Wake();
+    return Wait(ticket, IO_AXIS_FAULT);
+}
+
+void AxisActor::Forget()
+{
+    stale.store(true, memory_order_release);
+}
+
+bool AxisActor::Busy() const
+{
+    return pending.load(memory_order_acquire) > 0;
+}
+
+void AxisActor::RequestDisable()
+{
+    disableRequested.store(true, memory_order_release);
+    Wake();
+}
+
+void AxisActor::CopyError(char *out, size_t size)
+{
+    lock_guard<mutex> guard(lock);
+    strncpy(out, errorText, size - 1);
+    out[size - 1] = '\0';
+}
+
+AxisActorStats AxisActor::Stats()
+{
+    lock_guard<mutex> guard(lock);
+    return stats;
+}
+
+uint64_t AxisActor::Post(const Command &command)
+{
+    if (count == AXIS_QUEUE_CAPACITY)
+    {
+        stats.rejected++;
+        return 0;
+    }
+    Command &slot = queue[(head + count) % AXIS_QUEUE_CAPACITY];
+    slot = command;
+    slot.ticket = nextTicket++;
+    count++;
+    pending.fetch_add(1, memory_order_release);
+    return slot.ticket;
+}
+
+IoError AxisActor::Wait(uint64_t ticket, IoError error)
+{
+    unique_lock<mutex> guard(lock);
+    bool done = completed.wait_for(guard, chrono::duration<double>(AXIS_COMMAND_TIMEOUT),
+                                   [this, ticket]() { return doneTicket >= ticket; });
+    if (!done)
+    {
+        snprintf(errorText, sizeof(errorText), "axis command not made within %.1f s", AXIS_COMMAND_TIMEOUT);
+        return error;
+    }
+    // The one thread posting commands waits here, so a later failure is this one's.
+    return failedTicket >= ticket ? error : IO_OK;
+}
+
+// Async-signal-safe. The eventfd counts, so a wake-up that arrives while the
+// actor is busy is not lost.
+void AxisActor::Wake()
+{
+    uint64_t one = 1;
+    if (eventFd >= 0)
+        (void)!write(eventFd, &one, sizeof(one));
+}
+
+void AxisActor::Run()
+{
+    for (;;)
+    {
+        uint64_t wakeups;
+        if (read(eventFd, &wakeups, sizeof(wakeups)) < 0 && errno != EINTR)
+        {
+            perror("[Axis] eventfd read");
+            return;
+        }
+        if (disableRequested.load(memory_order_acquire))
+            Disable();
+        for (;;)
+        {
+            Command command;
+            {
+                lock_guard<mutex> guard(lock);
+                if (count == 0)
+                    break;
+                command = queue[head];
+                head = (head + 1) % AXIS_QUEUE_CAPACITY;
+                count--;
+            }
+            Execute(command);
+        }
+        if (stopping.load(memory_order_acquire))
+            return;
+    }
+}
+
+void AxisActor::Execute(const Command &command)
+{
+    Clock &clock = GetClock();
+    int64_t start = clock.NowNs();
+    bool failed = false;
+    char failure[sizeof(errorText)] = "";
+    try
+    {
+        switch (command.type)
+        {
+        case COMMAND_MOVE:
+            driver->Move(command.target, command.profile);
+            break;
+        case COMMAND_AMP:
+            driver->SetAmp(command.enabled);
+            break;
+        case COMMAND_CLEAR_FAULTS:
+            driver->ClearFaults();
+            break;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        failed = true;
+        snprintf(failure, sizeof(failure), "%s", e.what());
+    }
+    catch (...)
+    {
+        failed = true;
+        snprintf(failure, sizeof(failure), "unknown SDK error");
+    }
+    int64_t callNs = clock.NowNs() - start;
+
+    {
+        lock_guard<mutex> guard(lock);
+        stats.executed++;
+        stats.callNsSum += callNs;
+        stats.callNsMax = max(stats.callNsMax, callNs);
+        if (failed)
+        {
+            stats.failed++;
+            failedTicket = max(failedTicket, command.ticket);
+            memcpy(errorText, failure, sizeof(errorText));
+            if (command.type == COMMAND_MOVE)
+            {
+                moveFailed = true;
+                targetKnown = false;
+            }
+        }
+        doneTicket = max(doneTicket, command.ticket); // the disable on a signal has no ticket
+    }
+    pending.fetch_sub(1, memory_order_release);
+    completed.notify_all();
+}
+
+void AxisActor::Disable()
+{
+    bool wasEnabled;
+    {
+        lock_guard<mutex> guard(lock);
+        if (disabled)
+            return;
+        disabled = true;
+        stats.rejected += count;
+        pending.fetch_sub(count, memory_order_release);
+        if (count > 0)
+        {
+            failedTicket = nextTicket - 1;
+            doneTicket = nextTicket - 1;
+        }
+        count = 0;
+        targetKnown = false;
+        wasEnabled = ampEnabled;
+        ampEnabled = false;
+    }
+    completed.notify_all();
+    if (!wasEnabled)
+        return;
+    Command off{COMMAND_AMP, 0.0, {}, false};
+    pending.fetch_add(1, memory_order_release);
+    Execute(off);
+}
+
+void PrintAxisActorStats(int rig, const char *axis, const AxisActorStats &stats)
+{
+    if (stats.posted == 0)
+        return;
+    printf("[Rig %d] %s commands: %llu posted, %llu redundant, %llu coalesced, %llu rejected | "
+           "%llu SDK calls, %llu failed, mean %.1f us, max %.1f us\n",
+           rig, axis, (unsigned long long)stats.posted, (unsigned long long)stats.redundant,
+           (unsigned long long)stats.coalesced, (unsigned long long)stats.rejected,
+           (unsigned long long)stats.executed, (unsigned long long)stats.failed,
+           stats.executed ? stats.callNsSum / 1e3 / stats.executed : 0.0, stats.callNsMax / 1e3);
+}
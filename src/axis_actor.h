@@ -0,0 +1,131 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "launch_pipeline.h"
+#include "rt_setup.h"
+
+// === AXIS ACTORS ===
+// One thread per live axis, the only caller of that axis's command functions
+// in the SDK. Control code posts commands to a bounded queue and carries on;
+// the actor makes the calls in order, so two threads never drive one axis and
+// a slow call never holds up the caller's sensor polling.
+//
+// The actor keeps what was last commanded and leaves out commands that would
+// change nothing: a move to the target and profile the axis was already sent
+// (the door closing at the top of every launch after it closed at the end of
+// the last one), or turning off an amp that is already off. A move posted while
+// the previous one to the same axis is still queued replaces it, so a backlog
+// collapses to the latest target. Anything that may have moved the axis some
+// other way (a fault, clearing it) forgets the cached target.
+//
+// RequestDisable() is async-signal-safe: it sets a flag and writes an eventfd;
+// the actor turns the amp off, drops the queue and refuses commands from then on.
+
+constexpr int AXIS_QUEUE_CAPACITY = 8;
+constexpr double AXIS_COMMAND_TIMEOUT = 1.0; // s, for the commands the caller waits on
+
+// The SDK calls an actor makes. They may throw; the actor catches.
+class AxisDriver
+{
+public:
+    virtual ~AxisDriver() = default;
+    virtual void Move(double target, const MotionProfile &profile) = 0;
+    virtual void SetAmp(bool enabled) = 0;
+    virtual void ClearFaults() = 0;
+};
+
+struct AxisActorStats
+{
+    uint64_t posted = 0;    // commands asked for
+    uint64_t redundant = 0; // left out, nothing to change
+    uint64_t coalesced = 0; // moves replaced by a later one before they ran
+    uint64_t rejected = 0;  // queue full, or dropped once disabled
+    uint64_t executed = 0;  // SDK calls made
+    uint64_t failed = 0;
+    int64_t callNsSum = 0;
+    int64_t callNsMax = 0;
+};
+
+class AxisActor
+{
+public:
+    // `ampEnabled` is the amp state the axis is in now.
+    AxisActor(std::unique_ptr<AxisDriver> driver, bool ampEnabled);
+    ~AxisActor();
+
+    // Names the thread, pins it to `cpu` (-1 = not pinned) and runs it one
+    // priority step above `rt`, so a posted command preempts the control
+    // thread sharing its core.
+    void Start(const char *name, int cpu, const RtConfig &rt);
+    void Stop(); // after what is queued has run
+
+    // Returns once the move is queued. IO_AXIS_MOVE when it could not be, or
+    // when an earlier posted move failed; CopyError() says why.
+    IoError Move(double target, const MotionProfile &profile);
+    // Wait for the SDK call; IO_AXIS_FAULT when it failed or timed out.
+    IoError SetAmp(bool enabled);
+    IoError ClearFaults();
+
+    void Forget();         // the axis may not be where it was sent; lock-free
+    bool Busy() const;     // posted commands not made yet; lock-free
+    void RequestDisable(); // async-signal-safe
+    void CopyError(char *out, size_t size);
+    AxisActorStats Stats();
+
+private:
+    enum CommandType : uint8_t
+    {
+        COMMAND_MOVE,
+        COMMAND_AMP,
+        COMMAND_CLEAR_FAULTS
+    };
+
+    struct Command
+    {
+        CommandType type = COMMAND_MOVE;
+        double target = 0.0;
+        MotionProfile profile{};
+        bool enabled = false;
+        uint64_t ticket = 0;
+    };
+
+    uint64_t Post(const Command &command); // lock held; 0 = queue full
+    IoError Wait(uint64_t ticket, IoError error);
+    void Wake();
+    void Run();
+    void Execute(const Command &command);
+    void Disable();
+
+    std::unique_ptr<AxisDriver> driver;
+    int eventFd = -1;
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> disableRequested{false};
+    std::atomic<bool> stale{false};
+    std::atomic<int> pending{0};
+
+    // Everything below under `lock`.
+    std::mutex lock;
+    std::condition_variable completed;
+    Command queue[AXIS_QUEUE_CAPACITY];
+    int head = 0;
+    int count = 0;
+    uint64_t nextTicket = 1;
+    uint64_t doneTicket = 0;
+    uint64_t failedTicket = 0;
+    bool moveFailed = false; // an asynchronous move failed and was not reported yet
+    char errorText[160] = "";
+    bool targetKnown = false;
+    double lastTarget = 0.0;
+    MotionProfile lastProfile{};
+    bool ampEnabled = false;
+    bool disabled = false;
+    AxisActorStats stats;
+};
+
+void PrintAxisActorStats(int rig, const char *axis, const AxisActorStats &stats);
@@ -0,0 +1,263 @@
+#include "axis_trace.h"
+#include "trace_format.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace RSI::RapidCode;
+using namespace std;
+
+namespace
+{
+    enum class WindowState
+    {
+        IDLE,
+        CAPTURING,
+        POST_TRIGGER
+    };
+
+    struct TraceState
+    {
+        MotionController *controller = nullptr;
+        AxisTraceConfig config;
+        TraceWriter writer;
+        size_t channelCount = 0;
+        int axisCount = 0;
+        int32_t sensor1Mask = 0;
+        int32_t sensor2Mask = 0;
+
+        // Pre-trigger ring of the most recent records, channelCount values each.
+        vector<int64_t> ring;
+        size_t ringHead = 0;
+        size_t ringCount = 0;
+
+        WindowState state = WindowState::IDLE;
+        int32_t windowRecords = 0;
+        int32_t postRemaining = 0;
+
+        // Requests from the launch loop; -1 = none pending.
+        atomic<int64_t> beginRequest{-1};
+        atomic<bool> endRequest{false};
+        atomic<bool> running{false};
+        thread drainThread;
+    };
+
+    TraceState gTrace;
+
+    void PushRing(const int64_t *record)
+    {
+        size_t capacity = gTrace.ring.size() / gTrace.channelCount;
+        if (capacity == 0)
+            return;
+        copy(record, record + gTrace.channelCount, gTrace.ring.begin() + gTrace.ringHead * gTrace.channelCount);
+        gTrace.ringHead = (gTrace.ringHead + 1) % capacity;
+        gTrace.ringCount = min(gTrace.ringCount + 1, capacity);
+    }
+
+    void FlushRing()
+    {
+        size_t capacity = gTrace.ring.size() / gTrace.channelCount;
+        size_t start = (gTrace.ringHead + capacity - gTrace.ringCount) % max<size_t>(capacity, 1);
+        for (size_t i = 0; i < gTrace.ringCount; i++)
+        {
+            size_t slot = (start + i) % capacity;
+            gTrace.writer.WriteRecord(&gTrace.ring[slot * gTrace.channelCount]);
+        }
+        gTrace.windowRecords = static_cast<int32_t>(gTrace.ringCount);
+        gTrace.ringCount = 0;
+        gTrace.ringHead = 0;
+    }
+
+    void HandleRecord(const int64_t *record)
+    {
+        int64_t launchId = gTrace.beginRequest.exchange(-1);
+        if (launchId >= 0)
+        {
+            // A new launch always starts a fresh window, even if the previous one is still in post-trigger.
+            gTrace.writer.EndWindow();
+            gTrace.writer.BeginWindow(static_cast<uint32_t>(launchId));
+            gTrace.endRequest = false;
+            FlushRing();
+            gTrace.state = WindowState::CAPTURING;
+        }
+
+        switch (gTrace.state)
+        {
+        case WindowState::IDLE:
+            PushRing(record);
+            return;
+        case WindowState::CAPTURING:
+            gTrace.writer.WriteRecord(record);
+            gTrace.windowRecords++;
+            if (gTrace.endRequest.exchange(false))
+            {
+                gTrace.postRemaining = gTrace.config.postTriggerRecords;
+                gTrace.state = WindowState::POST_TRIGGER;
+            }
+            break;
+        case WindowState::POST_TRIGGER:
+            gTrace.writer.WriteRecord(record);
+            gTrace.windowRecords++;
+            gTrace.postRemaining--;
+            break;
+        }
+
+        if ((gTrace.state == WindowState::POST_TRIGGER && gTrace.postRemaining <= 0) ||
+            gTrace.windowRecords >= gTrace.config.maxWindowRecords)
+        {
+            if (gTrace.windowRecords >= gTrace.config.maxWindowRecords)
+                cerr << "[Trace] Window reached " << gTrace.windowRecords << " records, closing early.\n";
+            gTrace.writer.EndWindow();
+            gTrace.state = WindowState::IDLE;
+        }
+    }
+
+    void DrainLoop()
+    {
+        const int32_t recorder = gTrace.config.recorderNumber;
+        vector<int64_t> record(gTrace.channelCount);
+
+        while (gTrace.running)
+        {
+            int32_t count = 0;
+            try
+            {
+                count = gTrace.controller->RecorderRecordCountGet(recorder);
+                for (int32_t r = 0; r < count; r++)
+                {
+                    gTrace.controller->RecorderRecordDataRetrieve(recorder);
+
+                    // Recorder slots: sample counter, then 3 doubles per axis, then 2 input words.
+                    size_t slot = 0;
+                    record[slot] = static_cast<uint32_t>(gTrace.controller->RecorderRecordDataValueGet(recorder, slot));
+                    slot++;
+                    for (int a = 0; a < gTrace.axisCount * 3; a++, slot++)
+                        record[slot] = llround(gTrace.controller->RecorderRecordDataDoubleGet(recorder, slot));
+                    int32_t word1 = gTrace.controller->RecorderRecordDataValueGet(recorder, slot);
+                    int32_t word2 = gTrace.controller->RecorderRecordDataValueGet(recorder, slot + 1);
+                    record[slot] = ((word1 & gTrace.sensor1Mask) ? 1 : 0) | ((word2 & gTrace.sensor2Mask) ? 2 : 0);
+
+                    HandleRecord(record.data());
+                }
+            }
+            catch (const std::exception &e)
+            {
+                cerr << "[Trace] Recorder drain failed: " << e.what() << endl;
+            }
+
+            if (count == 0)
+                this_thread::sleep_for(chrono::milliseconds(2));
+        }
+    }
+}
+
+bool AxisTraceStart(MotionController *controller, Axis *const *axes, int axisCount,
+                    IOPoint *sensor1, IOPoint *sensor2, const AxisTraceConfig &config)
+{
+    if (gTrace.running || !controller || !sensor1 || !sensor2)
+        return false;
+
+    gTrace.controller = controller;
+    gTrace.config = config;
+    gTrace.axisCount = axisCount;
+    gTrace.channelCount = 1 + axisCount * 3 + 1;
+
+    TraceHeader header;
+    header.channels.push_back({TRACE_SAMPLE, 0, 1.0});
+    try
+    {
+        const int32_t recorder = config.recorderNumber;
+        header.sampleRate = controller->SampleRateGet() / config.periodSamples;
+
+        if (controller->RecorderEnabledGet(recorder))
+            controller->RecorderStop(recorder);
+        controller->RecorderReset(recorder);
+        controller->RecorderPeriodSet(recorder, config.periodSamples);
+        controller->RecorderCircularBufferSet(recorder, false);
+        controller->RecorderDataCountSet(recorder, static_cast<int32_t>(gTrace.channelCount + 1));
+
+        int32_t slot = 0;
+        controller->RecorderDataAddressSet(recorder, slot++, controller->AddressGet(RSIControllerAddressType::RSIControllerAddressTypeSAMPLE_COUNTER), RSIDataType::RSIDataTypeUINT32);
+        for (int a = 0; a < axisCount; a++)
+        {
+            double countsPerUnit = axes[a]->UserUnitsGet();
+            uint8_t axis = static_cast<uint8_t>(a);
+            controller->RecorderDataAddressSet(recorder, slot++, axes[a]->AddressGet(RSIAxisAddressType::RSIAxisAddressTypeCOMMAND_POSITION), RSIDataType::RSIDataTypeDOUBLE);
+            controller->RecorderDataAddressSet(recorder, slot++, axes[a]->AddressGet(RSIAxisAddressType::RSIAxisAddressTypeACTUAL_POSITION), RSIDataType::RSIDataTypeDOUBLE);
+            controller->RecorderDataAddressSet(recorder, slot++, axes[a]->AddressGet(RSIAxisAddressType::RSIAxisAddressTypePOSITION_ERROR), RSIDataType::RSIDataTypeDOUBLE);
+            header.channels.push_back({TRACE_COMMAND_POSITION, axis, countsPerUnit});
+            header.channels.push_back({TRACE_ACTUAL_POSITION, axis, countsPerUnit});
+            header.channels.push_back({TRACE_POSITION_ERROR, axis, countsPerUnit});
+        }
+        controller->RecorderDataAddressSet(recorder, slot++, sensor1->AddressGet(), RSIDataType::RSIDataTypeINT32);
+        controller->RecorderDataAddressSet(recorder, slot++, sensor2->AddressGet(), RSIDataType::RSIDataTypeINT32);
+        header.channels.push_back({TRACE_SENSORS, 0, 1.0});
+        gTrace.sensor1Mask = sensor1->MaskGet();
+        gTrace.sensor2Mask = sensor2->MaskGet();
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "[Trace] Recorder configuration failed: " << e.what() << endl;
+        return false;
+    }
+
+    if (!gTrace.writer.Open(config.path, header))
+    {
+        cerr << "[Trace] Could not open " << config.path << endl;
+        return false;
+    }
+
+    gTrace.ring.assign(static_cast<size_t>(max(config.preTriggerRecords, 0)) * gTrace.channelCount, 0);
+    gTrace.ringHead = gTrace.ringCount = 0;
+    gTrace.state = WindowState::IDLE;
+
+    try
+    {
+        controller->RecorderStart(config.recorderNumber);
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "[Trace] Recorder start failed: " << e.what() << endl;
+        gTrace.writer.Close();
+        return false;
+    }
+
+    gTrace.running = true;
+    gTrace.drainThread = thread(DrainLoop);
+    cout << "[Trace] Recording " << gTrace.channelCount << " channels at " << header.sampleRate << " Hz to " << config.path << "\n";
+    return true;
+}
+
+void AxisTraceWindowBegin(uint32_t launchId)
+{
+    if (gTrace.running)
+        gTrace.beginRequest = launchId;
+}
+
+void AxisTraceWindowEnd()
+{
+    if (gTrace.running)
+        gTrace.endRequest = true;
+}
+
+void AxisTraceStop()
+{
+    if (!gTrace.running)
+        return;
+    gTrace.running = false;
+    if (gTrace.drainThread.joinable())
+        gTrace.drainThread.join();
+    try
+    {
+        gTrace.controller->RecorderStop(gTrace.config.recorderNumber);
+    }
+    catch (const std::exception &e)
+    {
+        cerr << "[Trace] Recorder stop failed: " << e.what() << endl;
+    }
+    gTrace.writer.Close();
+    cout << "[Trace] Wrote " << gTrace.writer.BytesWritten() << " bytes.\n";
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "rsi.h"
+
+// === AXIS TRACE ===
+// Records command position, actual position and following error of each axis
+// plus both sensor bits at servo rate using the controller's data recorder.
+// A background thread drains the recorder and writes capture windows around
+// each launch to a delta-encoded trace file (see trace_format.h). Between
+// windows only a short pre-trigger history is kept in memory.
+
+struct AxisTraceConfig
+{
+    std::string path = "hotwheels_trace.bin";
+    int32_t recorderNumber = 0;
+    uint32_t periodSamples = 1;       // 1 = every servo sample
+    int32_t preTriggerRecords = 500;  // history written ahead of each window
+    int32_t postTriggerRecords = 3000; // records written after the window is closed
+    int32_t maxWindowRecords = 60000; // hard cap so a stuck launch cannot fill the disk
+};
+
+bool AxisTraceStart(RSI::RapidCode::MotionController *controller,
+                    RSI::RapidCode::Axis *const *axes, int axisCount,
+                    RSI::RapidCode::IOPoint *sensor1, RSI::RapidCode::IOPoint *sensor2,
+                    const AxisTraceConfig &config);
+void AxisTraceWindowBegin(uint32_t launchId); // called by the launch loop, never blocks
+void AxisTraceWindowEnd();                    // window closes after postTriggerRecords more records
+void AxisTraceStop();
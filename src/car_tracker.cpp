@@ -0,0 +1,220 @@
+#include "car_tracker.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+void TrackerStats::Merge(const TrackerStats &other)
+{
+    headwayMin = (headways == 0) ? other.headwayMin : (other.headways ? min(headwayMin, other.headwayMin) : headwayMin);
+    catcherGapMin = (catcherGaps == 0) ? other.catcherGapMin
+                                       : (other.catcherGaps ? min(catcherGapMin, other.catcherGapMin) : catcherGapMin);
+    cars += other.cars;
+    overlapped += other.overlapped;
+    maxInFlight = max(maxInFlight, other.maxInFlight);
+    headways += other.headways;
+    headwaySum += other.headwaySum;
+    catcherGaps += other.catcherGaps;
+    catcherConflicts += other.catcherConflicts;
+    bounces += other.bounces;
+    unexpectedEdges += other.unexpectedEdges;
+    missedEdges += other.missedEdges;
+    implausibleEdges += other.implausibleEdges;
+}
+
+bool CarTracker::CanAdmit() const
+{
+    if (count == 0)
+        return true;
+    const TrackedCar &newest = At(count - 1);
+    return count < TRACKER_CAPACITY && newest.edges[1] != 0 && newest.clearedSensor2;
+}
+
+LaunchRecord &CarTracker::Admit(double distance)
+{
+    sensorDistance = distance;
+    if (InFlight() > 0)
+        stats.overlapped++;
+    TrackedCar &car = At(count++);
+    car = TrackedCar{};
+    stats.cars++;
+    return car.record;
+}
+
+void CarTracker::Poll(const StatusSnapshot &status, int64_t now)
+{
+    for (int s = 0; s < 2; s++)
+    {
+        bool level = status.sensors[s];
+        if (level && !levels[s])
+            RisingEdge(s, now);
+        else if (!level && levels[s])
+        {
+            lastFall[s] = now;
+            // Only the newest car can still be in the sensor 2 beam.
+            if (s == 1 && count > 0 && At(count - 1).edges[1] != 0)
+                At(count - 1).clearedSensor2 = true;
+        }
+        levels[s] = level;
+    }
+
+    // The catcher's current move belongs to the newest car in flight; older
+    // ones only wait out their landing time.
+    int newestInFlight = -1;
+    for (int i = 0; i < count; i++)
+    {
+        if (At(i).state == CAR_IN_FLIGHT)
+            newestInFlight = i;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        TrackedCar &car = At(i);
+        if (car.state != CAR_IN_FLIGHT)
+            continue;
+        car.detector.Sample(status, now);
+        if (i == newestInFlight && !car.settled && now >= car.commandNs && status.motionDone[CATCHER])
+        {
+            car.settled = true;
+            car.record.catcherSettle = (now - car.commandNs) * 1e-9;
+            car.record.catcherError = status.actualPosition[CATCHER] - car.record.landing;
+        }
+        bool settled = car.settled || now >= car.landingNs + SecondsToNs(MOTION_DONE_TIMEOUT);
+        if (now >= car.landingNs && settled && car.detector.Done())
+            car.state = CAR_LANDED;
+    }
+}
+
+void CarTracker::RisingEdge(int sensor, int64_t now)
+{
+    if (lastFall[sensor] != 0 && now - lastFall[sensor] <= EDGE_BOUNCE_NS)
+    {
+        stats.bounces++;
+        return;
+    }
+    // Cars ahead are all past the beams, so only the newest one can need an edge.
+    TrackedCar *car = count > 0 ? &At(count - 1) : nullptr;
+    if (sensor == 0)
+    {
+        if (!car || car->state != CAR_ON_RAMP)
+        {
+            stats.unexpectedEdges++;
+            return;
+        }
+        car->edges[0] = now;
+        car->state = CAR_BETWEEN_BEAMS;
+        if (previousEdge1 != 0)
+        {
+            double headway = (now - previousEdge1) * 1e-9;
+            stats.headwayMin = stats.headways ? min(stats.headwayMin, headway) : headway;
+            stats.headwaySum += headway;
+            stats.headways++;
+        }
+        previousEdge1 = now;
+        return;
+    }
+
+    if (car && car->state == CAR_ON_RAMP)
+    {
+        // Sensor 2 first: the car went through sensor 1 unseen and cannot be timed.
+        stats.missedEdges++;
+        car->state = CAR_LOST;
+        return;
+    }
+    if (!car || car->state != CAR_BETWEEN_BEAMS)
+    {
+        stats.unexpectedEdges++;
+        return;
+    }
+    if (now - car->edges[0] < SecondsToNs(sensorDistance / MAX_PLAUSIBLE_SPEED))
+    {
+        stats.implausibleEdges++;
+        return;
+    }
+    car->edges[1] = now;
+    car->state = CAR_PAST_BEAMS;
+}
+
+int64_t CarTracker::LaunchingEdge(int sensor) const
+{
+    if (count == 0)
+        return 0;
+    const TrackedCar &car = At(count - 1);
+    return car.state == CAR_LOST ? -1 : car.edges[sensor - 1];
+}
+
+void CarTracker::Launched(const LaunchParams &params)
+{
+    TrackedCar &car = At(count - 1);
+    car.state = CAR_IN_FLIGHT;
+    car.commandNs = car.edges[1] + SecondsToNs(CatcherCommandTime(car.record));
+    car.landingNs = car.edges[1] + SecondsToNs(car.record.timeOfFlight);
+    car.detector.Arm(car.record, car.edges[1], params);
+
+    // The catcher has to be done with the car ahead before it leaves for this one.
+    int64_t aheadLanding = previousLanding;
+    for (int i = count - 2; i >= 0; i--)
+    {
+        if (At(i).state == CAR_IN_FLIGHT || At(i).state == CAR_LANDED)
+        {
+            aheadLanding = At(i).landingNs;
+            break;
+        }
+    }
+    if (aheadLanding != 0)
+    {
+        double gap = (car.commandNs - aheadLanding) * 1e-9;
+        stats.catcherGapMin = stats.catcherGaps ? min(stats.catcherGapMin, gap) : gap;
+        stats.catcherGaps++;
+        stats.catcherConflicts += gap < 0.0 ? 1 : 0;
+    }
+    stats.maxInFlight = max(stats.maxInFlight, InFlight());
+}
+
+void CarTracker::Drop()
+{
+    if (count > 0)
+        count--;
+}
+
+bool CarTracker::PopLanded(LaunchRecord &record)
+{
+    if (count == 0 || cars[head].state != CAR_LANDED)
+        return false;
+    cars[head].detector.Finish(cars[head].record);
+    record = cars[head].record;
+    previousLanding = cars[head].landingNs;
+    head = (head + 1) % TRACKER_CAPACITY;
+    count--;
+    return true;
+}
+
+void CarTracker::ForceLand()
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (At(i).state == CAR_IN_FLIGHT)
+            At(i).state = CAR_LANDED;
+    }
+}
+
+int CarTracker::InFlight() const
+{
+    int inFlight = 0;
+    for (int i = 0; i < count; i++)
+        inFlight += At(i).state == CAR_IN_FLIGHT ? 1 : 0;
+    return inFlight;
+}
+
+void PrintTrackerStats(int rig, const TrackerStats &stats)
+{
+    if (stats.cars == 0)
+        return;
+    printf("[Rig %d] Cars: %llu tracked, %llu admitted with another in flight (max %d in flight) | "
+           "headway mean %.3f s, min %.3f s | catcher gap min %.3f s, %llu conflicts\n",
+           rig, (unsigned long long)stats.cars, (unsigned long long)stats.overlapped, stats.maxInFlight,
+           stats.headways ? stats.headwaySum / stats.headways : 0.0, stats.headwayMin, stats.catcherGapMin,
+           (unsigned long long)stats.catcherConflicts);
+    printf("[Rig %d] Edges: %llu flicker, %llu unexpected, %llu missed (car dropped), %llu implausible\n", rig,
+           (unsigned long long)stats.bounces, (unsigned long long)stats.unexpectedEdges,
+           (unsigned long long)stats.missedEdges, (unsigned long long)stats.implausibleEdges);
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include "catch_detector.h"
+#include "launch_pipeline.h"
+
+// === CAR TRACKER ===
+// Lets the next car onto the ramp while the previous one is still in the
+// air. Cars are kept in FIFO order from admission to landing. While a tracker
+// is attached to a LaunchIO, every status poll of its waits goes through
+// Poll(), which assigns beam edges to the car that needs them, sorts out
+// edges no car explains (beam flicker, a missed or implausible edge, stray
+// objects), and completes in-flight cars once the catcher has settled and
+// their catch detector has an outcome. The next car is admitted only after the one
+// ahead has cleared sensor 2, so at most one car is ever short of the beams.
+
+constexpr int TRACKER_CAPACITY = 4;               // cars from admission to landing
+constexpr int64_t EDGE_BOUNCE_NS = 5 * NS_PER_MS; // a beam re-made this soon after breaking is the same car
+constexpr double MAX_PLAUSIBLE_SPEED = 10.0;      // m/s; a faster beam-to-beam time is not the tracked car
+
+enum CarState : uint8_t
+{
+    CAR_ON_RAMP = 0,   // admitted, sensor 1 not seen yet
+    CAR_BETWEEN_BEAMS, // sensor 1 edge assigned
+    CAR_PAST_BEAMS,    // sensor 2 edge assigned, catcher not commanded yet
+    CAR_IN_FLIGHT,     // catcher commanded
+    CAR_LANDED,        // caught, missed or given up on
+    CAR_LOST           // went through sensor 1 unseen; cannot be timed
+};
+
+struct TrackedCar
+{
+    LaunchRecord record;
+    CarState state = CAR_ON_RAMP;
+    bool clearedSensor2 = false;
+    bool settled = false;
+    int64_t edges[2] = {}; // clock ns, 0 = not seen
+    int64_t commandNs = 0; // catcher command
+    int64_t landingNs = 0; // predicted
+    CatchDetector detector;
+};
+
+struct TrackerStats
+{
+    uint64_t cars = 0;
+    uint64_t overlapped = 0;       // admitted while an earlier car was still in flight
+    int maxInFlight = 0;
+    uint64_t headways = 0;         // consecutive cars timed at sensor 1
+    double headwaySum = 0.0;       // s, sensor 1 to sensor 1
+    double headwayMin = 0.0;
+    uint64_t catcherGaps = 0;
+    double catcherGapMin = 0.0;    // s from the previous car's landing to this car's catcher command
+    uint64_t catcherConflicts = 0; // catcher commanded before the previous car landed
+    uint64_t bounces = 0;          // beam flicker inside EDGE_BOUNCE_NS, ignored
+    uint64_t unexpectedEdges = 0;  // no car could have caused it, ignored
+    uint64_t missedEdges = 0;      // sensor 2 before sensor 1: car dropped
+    uint64_t implausibleEdges = 0; // sensor 2 too soon after sensor 1, ignored
+
+    void Merge(const TrackerStats &other);
+};
+
+class CarTracker
+{
+public:
+    // The car ahead has cleared sensor 2 and there is room in the FIFO.
+    bool CanAdmit() const;
+    LaunchRecord &Admit(double sensorDistance); // only after CanAdmit()
+
+    // Every status read of a wait; no allocation, no output.
+    void Poll(const StatusSnapshot &status, int64_t nowNs);
+
+    // The newest car's edge on `sensor`: clock ns, 0 = not yet, -1 = car lost.
+    int64_t LaunchingEdge(int sensor) const;
+    void Launched(const LaunchParams &params); // the newest car's catcher command is out and its record filled in
+    void Drop();     // the newest car's launch did not complete
+
+    bool PopLanded(LaunchRecord &record); // oldest car, once it has landed; fills in its outcome
+    void ForceLand();                     // gives up waiting on cars still in flight
+    int InFlight() const;
+    bool Empty() const { return count == 0; }
+    const TrackerStats &Stats() const { return stats; }
+
+private:
+    TrackedCar &At(int index) { return cars[(head + index) % TRACKER_CAPACITY]; }
+    const TrackedCar &At(int index) const { return cars[(head + index) % TRACKER_CAPACITY]; }
+    void RisingEdge(int sensor, int64_t nowNs);
+
+    TrackedCar cars[TRACKER_CAPACITY];
+    int head = 0;
+    int count = 0;
+    bool levels[2] = {};
+    int64_t lastFall[2] = {}; // ns, for flicker
+    double sensorDistance = SENSOR_DISTANCE;
+    int64_t previousEdge1 = 0;
+    int64_t previousLanding = 0; // ns, of the last car to leave the FIFO in flight
+    TrackerStats stats;
+};
+
+void PrintTrackerStats(int rig, const TrackerStats &stats);
@@ -0,0 +1,77 @@
+#include "catch_detector.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+void CatchDetector::Arm(const LaunchRecord &record, int64_t edge2, const LaunchParams &params)
+{
+    *this = CatchDetector{};
+    armed = true;
+    errorThreshold = params.catchErrorThreshold;
+    outputThreshold = params.catchOutputThreshold;
+    horizontalSpeed = record.speed * cos(record.angle * M_PI / 180.0);
+    edge2Ns = edge2;
+    landingNs = edge2 + SecondsToNs(record.timeOfFlight);
+    windowStart = landingNs - SecondsToNs(CATCH_WINDOW_BEFORE);
+    windowEnd = landingNs + SecondsToNs(CATCH_WINDOW_AFTER);
+}
+
+void CatchDetector::Sample(const StatusSnapshot &status, int64_t now)
+{
+    if (Done() || now <= lastNs)
+        return;
+    double error = status.followingError[CATCHER];
+    double output = status.filterOutput[CATCHER];
+    if (!primed)
+    {
+        errorBaseline = error;
+        outputBaseline = output;
+        primed = true;
+        gap = now > windowStart; // no baseline from before the window
+        lastNs = now;
+        return;
+    }
+
+    if (now >= windowStart)
+    {
+        gap = gap || now - max(lastNs, windowStart) > CATCH_MAX_GAP_NS;
+        // A tripped axis jumps too; nothing after it says anything about the car.
+        faulted = faulted || status.fault[CATCHER];
+        bool jumped = fabs(error - errorBaseline) > errorThreshold ||
+                      (outputThreshold > 0.0 && fabs(output - outputBaseline) > outputThreshold);
+        if (!faulted && jumped)
+        {
+            impactNs = now;
+            return;
+        }
+    }
+
+    // The catcher's own moves change both slowly; the baseline follows them.
+    double alpha = min((now - lastNs) * 1e-9 / CATCH_BASELINE_TAU, 1.0);
+    errorBaseline += alpha * (error - errorBaseline);
+    outputBaseline += alpha * (output - outputBaseline);
+    lastNs = now;
+}
+
+bool CatchDetector::Done() const
+{
+    return !armed || impactNs != 0 || faulted || lastNs >= windowEnd;
+}
+
+void CatchDetector::Finish(LaunchRecord &record) const
+{
+    record.outcome = CATCH_UNKNOWN;
+    record.impactTime = 0.0;
+    record.impactPosition = 0.0;
+    if (!armed || faulted)
+        return;
+    if (impactNs != 0)
+    {
+        record.outcome = CATCH_CAUGHT;
+        record.impactTime = (impactNs - landingNs) * 1e-9;
+        record.impactPosition = horizontalSpeed * (impactNs - edge2Ns) * 1e-9;
+    }
+    else if (!gap && lastNs >= windowEnd)
+        record.outcome = CATCH_MISSED;
+}
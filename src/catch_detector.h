@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include "launch_pipeline.h"
+
+// === CATCH DETECTION ===
+// Tells from the catcher axis alone whether the car was caught. A car landing
+// in the catcher knocks the carriage: the following error and the drive's
+// filter output jump away from their recent level. The detector keeps a short
+// moving baseline of both and, in a window around the predicted landing time,
+// takes the first sample that departs from it by more than the thresholds
+// (catch_error_threshold, catch_output_threshold) as the impact. No impact
+// by the end of the window is a miss; a catcher fault, or a gap of more than
+// CATCH_MAX_GAP_NS in the samples, leaves the outcome unknown.
+//
+// The impact point is estimated from the measured flight: horizontal speed
+// times the time from the sensor 2 edge to the impact. Sample() does no
+// allocation or output, so it can run from every poll of a wait.
+
+constexpr double CATCH_WINDOW_BEFORE = 0.10; // s before the predicted landing
+constexpr double CATCH_WINDOW_AFTER = 0.25;  // s after it
+constexpr double CATCH_BASELINE_TAU = 0.02;  // s, following error/output baseline time constant
+constexpr int64_t CATCH_MAX_GAP_NS = 20 * NS_PER_MS; // longer between samples and a miss cannot be told
+
+class CatchDetector
+{
+public:
+    // Starts watching for a car that left sensor 2 at `edge2` (clock ns).
+    void Arm(const LaunchRecord &record, int64_t edge2, const LaunchParams &params);
+    void Sample(const StatusSnapshot &status, int64_t nowNs);
+    bool Done() const; // impact seen, window over, or never armed
+    void Finish(LaunchRecord &record) const;
+
+private:
+    bool armed = false;
+    double errorThreshold = 0.0;
+    double outputThreshold = 0.0; // 0 = following error only
+    double horizontalSpeed = 0.0; // m/s
+    int64_t edge2Ns = 0;
+    int64_t landingNs = 0;        // predicted
+    int64_t windowStart = 0;
+    int64_t windowEnd = 0;
+
+    bool primed = false;
+    double errorBaseline = 0.0;
+    double outputBaseline = 0.0;
+    int64_t lastNs = 0;
+    bool gap = false;             // the window was not sampled throughout
+    bool faulted = false;
+    int64_t impactNs = 0;         // 0 = none
+};
@@ -0,0 +1,237 @@
+#include "clock.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    MonotonicClock gMonotonicClock;
+    Clock *gClock = &gMonotonicClock;
+    thread_local Clock *tClock = nullptr;
+
+    constexpr int TSC_PAIR_TRIES = 5;
+
+    // A (raw ns, ticks) pair read as close together as the clock allows: the
+    // tightest of a few raw/TSC/raw brackets, stamped at its midpoint.
+    void SamplePair(int64_t &ns, uint64_t &ticks)
+    {
+        int64_t tightest = INT64_MAX;
+        for (int i = 0; i < TSC_PAIR_TRIES; i++)
+        {
+            int64_t before = RawClockNs();
+            uint64_t sample = TscClock::NowTicks();
+            int64_t after = RawClockNs();
+            if (after - before < tightest)
+            {
+                tightest = after - before;
+                ns = before + tightest / 2;
+                ticks = sample;
+            }
+        }
+    }
+
+    uint64_t Multiplier(double nsPerTick)
+    {
+        return static_cast<uint64_t>(llround(nsPerTick * 4294967296.0)); // 32.32 fixed point
+    }
+}
+
+Clock &GetClock()
+{
+    return tClock ? *tClock : *gClock;
+}
+
+void SetClock(Clock &clock)
+{
+    gClock = &clock;
+}
+
+void SetThreadClock(Clock *clock)
+{
+    tClock = clock;
+}
+
+// === MONOTONIC CLOCK ===
+int64_t MonotonicClock::NowNs()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void MonotonicClock::SleepUntil(int64_t deadlineNs)
+{
+    this_thread::sleep_until(chrono::steady_clock::time_point(chrono::nanoseconds(deadlineNs)));
+}
+
+// === TSC CLOCK ===
+int64_t RawClockNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+    return static_cast<int64_t>(now.tv_sec) * NS_PER_SECOND + now.tv_nsec;
+}
+
+bool TscInvariant()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8)))
+        return false;
+    // The kernel drops "tsc" from the list once it has seen it misbehave (e.g. unsynchronized sockets).
+    ifstream file("/sys/devices/system/clocksource/clocksource0/available_clocksource");
+    string line, source;
+    if (!getline(file, line))
+        return true;
+    istringstream sources(line);
+    while (sources >> source)
+    {
+        if (source == "tsc")
+            return true;
+    }
+    return false;
+#else
+    return false;
+#endif
+}
+
+uint64_t TscClock::NowTicks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(RawClockNs());
+#endif
+}
+
+TscClock::TscClock()
+{
+    int64_t startNs, endNs;
+    uint64_t startTicks, endTicks;
+    SamplePair(startNs, startTicks);
+    while (RawClockNs() < startNs + TSC_CALIBRATION_NS)
+    {
+    }
+    SamplePair(endNs, endTicks);
+
+    double nsPerTick = static_cast<double>(endNs - startNs) / static_cast<double>(endTicks - startTicks);
+    calibrationTicks = startTicks;
+    calibrationNs = startNs;
+    ticksPerSecond.store(1e9 / nsPerTick, memory_order_relaxed);
+    baseTicks.store(endTicks, memory_order_relaxed);
+    baseNs.store(endNs, memory_order_relaxed);
+    mult.store(Multiplier(nsPerTick), memory_order_relaxed);
+    nextRecheckNs.store(endNs + TSC_RECHECK_PERIOD_NS, memory_order_relaxed);
+}
+
+int64_t TscClock::TicksToNs(uint64_t ticks) const
+{
+    uint32_t before, after;
+    uint64_t t0, m;
+    int64_t n0;
+    do
+    {
+        before = sequence.load(memory_order_acquire);
+        t0 = baseTicks.load(memory_order_relaxed);
+        n0 = baseNs.load(memory_order_relaxed);
+        m = mult.load(memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        after = sequence.load(memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    // Ticks read just before a recheck moved the base come out negative, which is fine.
+    __int128 scaled = static_cast<__int128>(static_cast<int64_t>(ticks - t0)) * static_cast<__int128>(m);
+    return n0 + static_cast<int64_t>(scaled >> 32);
+}
+
+bool TscClock::Recheck()
+{
+    if (rechecking.exchange(true, memory_order_acquire))
+        return false;
+
+    int64_t rawNs;
+    uint64_t ticks;
+    SamplePair(rawNs, ticks);
+    int64_t clockNs = TicksToNs(ticks);
+    int64_t drift = clockNs - rawNs;
+
+    // Rate from the whole run so far; offset removed over the next period
+    // by a bounded rate change rather than a step.
+    double nsPerTick = static_cast<double>(rawNs - calibrationNs) / static_cast<double>(ticks - calibrationTicks);
+    double slew = clamp(static_cast<double>(drift) / TSC_RECHECK_PERIOD_NS, -TSC_MAX_SLEW, TSC_MAX_SLEW);
+
+    uint32_t seq = sequence.load(memory_order_relaxed);
+    sequence.store(seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    baseTicks.store(ticks, memory_order_relaxed);
+    baseNs.store(clockNs, memory_order_relaxed);
+    mult.store(Multiplier(nsPerTick * (1.0 - slew)), memory_order_relaxed);
+    sequence.store(seq + 2, memory_order_release);
+
+    ticksPerSecond.store(1e9 / nsPerTick, memory_order_relaxed);
+    lastDriftNs.store(drift, memory_order_relaxed);
+    nextRecheckNs.store(rawNs + TSC_RECHECK_PERIOD_NS, memory_order_relaxed);
+    rechecking.store(false, memory_order_release);
+    return true;
+}
+
+// Sleeps relative to CLOCK_MONOTONIC; over one poll period its slewing is far below a microsecond.
+void TscClock::SleepUntil(int64_t deadlineNs)
+{
+    int64_t now = NowNs();
+    if (now >= nextRecheckNs.load(memory_order_relaxed) && Recheck())
+        now = NowNs();
+    if (deadlineNs <= now)
+        return;
+    int64_t remaining = deadlineNs - now;
+    timespec duration = {static_cast<time_t>(remaining / NS_PER_SECOND), static_cast<long>(remaining % NS_PER_SECOND)};
+    while (clock_nanosleep(CLOCK_MONOTONIC, 0, &duration, &duration) == EINTR)
+    {
+    }
+}
+
+bool SelectTscClock()
+{
+    if (!TscInvariant())
+        return false;
+    static TscClock tscClock;
+    SetClock(tscClock);
+    return true;
+}
+
+// === VIRTUAL CLOCK ===
+void VirtualClock::SleepUntil(int64_t deadlineNs)
+{
+    while (!events.empty() && events.top().at <= deadlineNs)
+    {
+        Event event = events.top();
+        events.pop();
+        if (event.at > now)
+            now = event.at;
+        event.action();
+    }
+    if (deadlineNs > now)
+        now = deadlineNs;
+}
+
+void VirtualClock::Schedule(int64_t atNs, function<void()> event)
+{
+    events.push({atNs, nextSequence++, move(event)});
+}
+
+void VirtualClock::Reset(int64_t nowNs)
+{
+    events = {};
+    now = nowNs;
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+// === CLOCK ===
+// Every wait in the launch path goes through the global clock so the same
+// control logic can run against the real monotonic clock or a virtual one.
+// A thread may override it with its own clock (one virtual clock per rig).
+
+constexpr int64_t NS_PER_MS = 1000000;
+constexpr int64_t NS_PER_SECOND = 1000000000;
+
+inline int64_t SecondsToNs(double seconds) { return static_cast<int64_t>(seconds * NS_PER_SECOND); }
+
+class Clock
+{
+public:
+    virtual ~Clock() = default;
+
+    virtual int64_t NowNs() = 0;
+    virtual void SleepUntil(int64_t deadlineNs) = 0;
+
+    void SleepFor(int64_t durationNs) { SleepUntil(NowNs() + durationNs); }
+    double NowSeconds() { return NowNs() * 1e-9; }
+};
+
+// steady_clock (CLOCK_MONOTONIC) and real sleeps.
+class MonotonicClock : public Clock
+{
+public:
+    int64_t NowNs() override;
+    void SleepUntil(int64_t deadlineNs) override;
+};
+
+// === TSC CLOCK ===
+// Reads the invariant TSC (no syscall) and converts ticks to ns with a 32.32
+// fixed-point multiplier calibrated against CLOCK_MONOTONIC_RAW, so NowNs()
+// is in the raw monotonic timebase. Recheck() re-measures the rate over
+// everything since calibration and slews any offset out over the next
+// TSC_RECHECK_PERIOD_NS; the clock never steps. SleepUntil() runs the recheck
+// when it is due, so the control loops keep it calibrated from their idle time.
+constexpr int64_t TSC_CALIBRATION_NS = 20 * NS_PER_MS; // initial measuring window
+constexpr int64_t TSC_RECHECK_PERIOD_NS = NS_PER_SECOND;
+constexpr double TSC_MAX_SLEW = 500e-6; // largest rate correction applied by one recheck
+
+bool TscInvariant();  // constant-rate TSC the kernel also trusts as a clocksource
+int64_t RawClockNs(); // CLOCK_MONOTONIC_RAW
+
+class TscClock : public Clock
+{
+public:
+    TscClock(); // calibrates, which takes TSC_CALIBRATION_NS
+
+    static uint64_t NowTicks(); // rdtsc; CLOCK_MONOTONIC_RAW ns where there is no TSC
+    int64_t TicksToNs(uint64_t ticks) const;
+
+    int64_t NowNs() override { return TicksToNs(NowTicks()); }
+    void SleepUntil(int64_t deadlineNs) override;
+
+    // False if another thread is rechecking right now.
+    bool Recheck();
+    double TicksPerSecond() const { return ticksPerSecond.load(std::memory_order_relaxed); }
+    int64_t LastDriftNs() const { return lastDriftNs.load(std::memory_order_relaxed); } // clock minus raw before the last recheck
+
+private:
+    // ns = baseNs + ((ticks - baseTicks) * mult >> 32), published under a sequence lock.
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint64_t> baseTicks{0};
+    std::atomic<int64_t> baseNs{0};
+    std::atomic<uint64_t> mult{0};
+
+    uint64_t calibrationTicks = 0; // the rate is always measured from here
+    int64_t calibrationNs = 0;
+    std::atomic<double> ticksPerSecond{0.0};
+    std::atomic<bool> rechecking{false};
+    std::atomic<int64_t> nextRecheckNs{0};
+    std::atomic<int64_t> lastDriftNs{0};
+};
+
+// Makes a TscClock the global clock when TscInvariant(), otherwise keeps
+// MonotonicClock (clock_gettime). Call before any rig thread starts. Returns
+// whether the TSC is in use.
+bool SelectTscClock();
+
+// Discrete-event clock: time only moves when the (single) control thread
+// sleeps, jumping straight to the deadline after running every event
+// scheduled before it in time order. Sleeping never blocks.
+class VirtualClock : public Clock
+{
+public:
+    int64_t NowNs() override { return now; }
+    void SleepUntil(int64_t deadlineNs) override;
+
+    void Schedule(int64_t atNs, std::function<void()> event);
+    void Reset(int64_t nowNs); // drops pending events
+
+private:
+    struct Event
+    {
+        int64_t at;
+        uint64_t sequence; // keeps same-time events in scheduling order
+        std::function<void()> action;
+
+        bool operator>(const Event &other) const
+        {
+            return at != other.at ? at > other.at : sequence > other.sequence;
+        }
+    };
+
+    int64_t now = 0;
+    uint64_t nextSequence = 0;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+};
+
+Clock &GetClock();
+void SetClock(Clock &clock);
+void SetThreadClock(Clock *clock); // calling thread only; nullptr = back to the global clock
@@ -0,0 +1,143 @@
+#include "fault_supervisor.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+
+void RecoveryStats::Merge(const RecoveryStats &other)
+{
+    faults += other.faults;
+    abortedLaunches += other.abortedLaunches;
+    recoveries += other.recoveries;
+    failedAttempts += other.failedAttempts;
+    skippedLaunches += other.skippedLaunches;
+    totalSeconds += other.totalSeconds;
+    maxSeconds = max(maxSeconds, other.maxSeconds);
+}
+
+namespace
+{
+    bool Healthy(LaunchIO &io, AxisID axis)
+    {
+        IoResult<AxisHealth> health = io.ReadAxisHealth(axis);
+        return health.Ok() && !health.value.fault && health.value.ampEnabled;
+    }
+
+    // Where the verification move sends each axis: door closed, catcher
+    // home, ramp held where it is.
+    IoResult<double> RestPosition(LaunchIO &io, AxisID axis, const LaunchParams &params)
+    {
+        if (axis == DOOR)
+            return {0.0};
+        if (axis == CATCHER)
+            return {params.minCatcherPosition};
+        return io.AxisActualPosition(axis);
+    }
+
+    void PrintAxes(uint32_t axes)
+    {
+        for (int a = 0; a < AXIS_COUNT; a++)
+        {
+            if (axes & (1u << a))
+                cerr << " " << AXIS_NAMES[a];
+        }
+    }
+}
+
+uint32_t CheckAxes(LaunchIO &io)
+{
+    uint32_t faulted = 0;
+    for (int a = 0; a < AXIS_COUNT; a++)
+    {
+        if (!Healthy(io, static_cast<AxisID>(a)))
+            faulted |= 1u << a;
+    }
+    return faulted;
+}
+
+bool RecoverAxes(LaunchIO &io, uint32_t axes, const LaunchParams &params)
+{
+    double deadline = io.Now() + RECOVERY_BUDGET;
+    for (int a = 0; a < AXIS_COUNT; a++)
+    {
+        AxisID axis = static_cast<AxisID>(a);
+        if (!(axes & (1u << a)))
+            continue;
+        if (io.ClearAxisFault(axis) != IO_OK || io.EnableAxis(axis) != IO_OK || io.ReferenceAxis(axis) != IO_OK)
+        {
+            cerr << "[Supervisor] " << AXIS_NAMES[a] << ": recovery step failed (" << io.ErrorDetail() << ")\n";
+            return false;
+        }
+    }
+
+    // Verify under motion: every recovered axis has to reach its rest position in time.
+    for (int a = 0; a < AXIS_COUNT; a++)
+    {
+        AxisID axis = static_cast<AxisID>(a);
+        if (!(axes & (1u << a)))
+            continue;
+        IoResult<double> rest = RestPosition(io, axis, params);
+        if (!rest.Ok() || io.MoveAxis(axis, rest.value, params.profiles[a]) != IO_OK)
+            return false;
+    }
+    for (int a = 0; a < AXIS_COUNT; a++)
+    {
+        AxisID axis = static_cast<AxisID>(a);
+        if (!(axes & (1u << a)))
+            continue;
+        double remaining = deadline - io.Now();
+        if (remaining <= 0.0 || !io.WaitMotionDone(axis, remaining))
+            return false;
+        IoResult<bool> done = io.MotionDone(axis);
+        if (!done.Ok() || !done.value || !Healthy(io, axis))
+            return false;
+    }
+    return true;
+}
+
+bool SuperviseAxes(LaunchIO &io, const LaunchParams &params, RecoveryStats &stats)
+{
+    uint32_t faulted = CheckAxes(io);
+    if (!faulted)
+        return true;
+
+    stats.faults += __builtin_popcount(faulted);
+    cerr << "[Supervisor] Axis fault:";
+    PrintAxes(faulted);
+    cerr << ", recovering\n";
+
+    double start = io.Now();
+    for (int attempt = 1; attempt <= RECOVERY_ATTEMPTS && !io.Aborted(); attempt++)
+    {
+        if (RecoverAxes(io, faulted, params) && !(faulted = CheckAxes(io)))
+        {
+            double seconds = io.Now() - start;
+            stats.recoveries++;
+            stats.totalSeconds += seconds;
+            stats.maxSeconds = max(stats.maxSeconds, seconds);
+            cerr << "[Supervisor] Recovered in " << seconds * 1000.0 << " ms (attempt " << attempt << ")\n";
+            return true;
+        }
+        stats.failedAttempts++;
+        faulted |= CheckAxes(io); // an unverified axis stays in the set even if it reads healthy now
+    }
+    stats.totalSeconds += io.Now() - start;
+    stats.skippedLaunches++;
+    cerr << "[Supervisor] Still faulted after " << RECOVERY_ATTEMPTS << " attempts:";
+    PrintAxes(faulted);
+    cerr << ", skipping this launch\n";
+    return false;
+}
+
+void PrintRecoveryStats(int rig, const RecoveryStats &stats)
+{
+    if (stats.faults == 0 && stats.abortedLaunches == 0)
+        return;
+    double mean = stats.recoveries ? stats.totalSeconds / stats.recoveries : 0.0;
+    printf("[Rig %d] Faults: %llu axes, %llu launches aborted | recovered %llu (mean %.1f ms, max %.1f ms), "
+           "%llu failed attempts, %llu launches skipped\n",
+           rig, (unsigned long long)stats.faults, (unsigned long long)stats.abortedLaunches,
+           (unsigned long long)stats.recoveries, mean * 1000.0, stats.maxSeconds * 1000.0,
+           (unsigned long long)stats.failedAttempts, (unsigned long long)stats.skippedLaunches);
+}
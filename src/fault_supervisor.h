@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include "launch_pipeline.h"
+
+// === FAULT SUPERVISOR ===
+// Keeps a rig launching through axis faults without a restart. Before every
+// launch it reads each axis's health; a faulted or amp-disabled axis gets the
+// recovery sequence: clear faults, enable the amp, re-reference, then a
+// verification move to its rest position (door closed, catcher home, ramp
+// where it stands) that has to finish inside the budget with the axis
+// healthy. During a launch the sensor waits watch the status fault flags and
+// abort the launch, so the next pass recovers the axis.
+
+constexpr double RECOVERY_BUDGET = 3.0; // s for one attempt, verification move included
+constexpr int RECOVERY_ATTEMPTS = 3;    // per launch gap; after that the launch is skipped
+
+struct RecoveryStats
+{
+    uint64_t faults = 0;          // faulted or disabled axes found between launches
+    uint64_t abortedLaunches = 0; // launches stopped by an axis fault
+    uint64_t recoveries = 0;      // sequences that left the rig healthy
+    uint64_t failedAttempts = 0;
+    uint64_t skippedLaunches = 0; // rig still unhealthy after RECOVERY_ATTEMPTS
+    double totalSeconds = 0.0;    // spent recovering, successful or not
+    double maxSeconds = 0.0;      // longest successful recovery
+
+    void Merge(const RecoveryStats &other);
+};
+
+// Axes (bit per AxisID) that are faulted or have their amp off; an axis whose
+// health cannot be read counts as faulted.
+uint32_t CheckAxes(LaunchIO &io);
+
+// One recovery attempt; true once every axis in `axes` is healthy and verified.
+bool RecoverAxes(LaunchIO &io, uint32_t axes, const LaunchParams &params);
+
+// Between launches: checks the axes and recovers up to RECOVERY_ATTEMPTS
+// times. False if the rig is still unhealthy and the launch should be skipped.
+bool SuperviseAxes(LaunchIO &io, const LaunchParams &params, RecoveryStats &stats);
+
+void PrintRecoveryStats(int rig, const RecoveryStats &stats);
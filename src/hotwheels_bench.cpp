@@ -0,0 +1,424 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <string>
+#include "axis_actor.h"
+#include "clock.h"
+#include "jitter_monitor.h"
+#include "landing_correction.h"
+#include "launch_log.h"
+#include "launch_model.h"
+#include "metrics.h"
+#include "sim_rig.h"
+#include "stream_stats.h"
+
+using namespace std;
+
+// hotwheels_bench: microbenchmarks for the primitives a launch is built from.
+// Runs against the simulated rig, so no controller or RSI SDK is needed.
+//   hotwheels_bench                  run everything
+//   hotwheels_bench <filter>         only benchmarks whose name contains <filter>
+//   hotwheels_bench -t <seconds>     minimum measuring time per benchmark (default 0.5)
+//   hotwheels_bench -d <seconds>     TSC clock drift against CLOCK_MONOTONIC_RAW instead
+
+constexpr const char *BENCH_SHM_NAME = "/hotwheels_bench";
+constexpr const char *NULL_DEVICE = "/dev/null";
+constexpr int INPUT_VARIANTS = 16; // inputs cycle through this many values so nothing folds to a constant
+constexpr int64_t DRIFT_SAMPLE_PERIOD_NS = 100 * NS_PER_MS;
+
+// Keeps `value` alive without adding more than a register move.
+template <typename T>
+inline void DoNotOptimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// === FIXTURE ===
+// Shared state the benchmarks run against: a simulated rig on a virtual clock
+// (installed as this thread's clock) with the ramp and catcher mid-move.
+struct BenchFixture
+{
+    VirtualClock clock;
+    SimLaunchIO io;
+    MonotonicClock monotonic;
+    TscClock tsc;
+    LaunchLogWriter log;
+    ofstream debugOut{NULL_DEVICE};
+    LaunchRecord record;
+    unique_ptr<StreamStat> stat = make_unique<StreamStat>();
+    unique_ptr<LaunchStatistics> statistics = make_unique<LaunchStatistics>();
+    vector<uint8_t> blob;
+
+    BenchFixture()
+    {
+        SetThreadClock(&clock);
+        io.MoveAxis(RAMP, 30.0, RAMP_PROFILE);
+        io.MoveAxis(CATCHER, 0.4, CATCHER_PROFILE);
+        log.Open(NULL_DEVICE);
+
+        record.angle = 30.0;
+        record.t1 = 1.0;
+        record.t2 = 1.05;
+        record.speed = 2.0;
+        record.landing = 0.4;
+        record.catcherCmd = 0.0005;
+        record.catcherSettle = 0.08;
+        record.catcherError = 0.001;
+        record.outcome = CATCH_CAUGHT;
+        record.impactPosition = 0.401;
+        for (int i = 0; i < 1000; i++)
+            statistics->Add(record);
+        MetricsOpen(BENCH_SHM_NAME);
+    }
+
+    ~BenchFixture()
+    {
+        MetricsClose();
+        SetThreadClock(nullptr);
+    }
+};
+
+BenchFixture *gFixture = nullptr;
+
+inline double Variant(uint64_t i) { return static_cast<double>(i % INPUT_VARIANTS); }
+
+// === PHYSICS ===
+void BenchComputeSpeed(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(ComputeSpeed(1.0, 1.05 + Variant(i) * 1e-3));
+}
+
+void BenchComputeTimeOfFlight(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(ComputeTimeOfFlight(2.0 + Variant(i) * 0.01, 30.0));
+}
+
+void BenchComputeLandingPosition(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(ComputeLandingPosition(2.0 + Variant(i) * 0.01, 30.0));
+}
+
+void BenchComputeMoveTime(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(ComputeMoveTime(CATCHER_PROFILE, 0.2 + Variant(i) * 0.01));
+}
+
+void BenchPlanLaunch(uint64_t iterations)
+{
+    LaunchParams params;
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(PlanLaunch(1.0, 1.05 + Variant(i) * 1e-3, 30.0, 0.2, params));
+}
+
+void BenchLandingCorrection(uint64_t iterations)
+{
+    LandingCorrection correction;
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(correction.Apply(2.0 + Variant(i) * 1e-3, 30.0));
+}
+
+// === CLOCK ===
+void BenchClockGettime(uint64_t iterations)
+{
+    timespec now;
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        DoNotOptimize(now);
+    }
+}
+
+void BenchSteadyClock(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(chrono::steady_clock::now());
+}
+
+void BenchMonotonicClock(uint64_t iterations)
+{
+    Clock &clock = gFixture->monotonic;
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(clock.NowNs());
+}
+
+void BenchTscTicks(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(TscClock::NowTicks());
+}
+
+// Ticks plus the sequence-locked conversion to ns.
+void BenchTscClock(uint64_t iterations)
+{
+    Clock &clock = gFixture->tsc;
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(clock.NowNs());
+}
+
+// What the live launch path pays: the thread/global lookup plus the virtual call.
+void BenchGetClockNow(uint64_t iterations)
+{
+    SetThreadClock(nullptr); // the global monotonic clock instead of the fixture's virtual one
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(GetClock().NowNs());
+    SetThreadClock(&gFixture->clock);
+}
+
+// === SIMULATED I/O ===
+void BenchSensorLevel(uint64_t iterations)
+{
+    LaunchIO &io = gFixture->io;
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(io.SensorLevel(1 + (i & 1)));
+}
+
+void BenchAxisActualPosition(uint64_t iterations)
+{
+    LaunchIO &io = gFixture->io;
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(io.AxisActualPosition(CATCHER));
+}
+
+void BenchMotionDone(uint64_t iterations)
+{
+    LaunchIO &io = gFixture->io;
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(io.MotionDone(CATCHER));
+}
+
+// The composed default: both sensors plus position and motion state of every axis.
+void BenchReadStatus(uint64_t iterations)
+{
+    LaunchIO &io = gFixture->io;
+    StatusSnapshot status;
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        io.ReadStatus(status);
+        DoNotOptimize(status);
+    }
+}
+
+// Includes the simulated command round trip, which only advances the virtual clock.
+void BenchMoveAxis(uint64_t iterations)
+{
+    LaunchIO &io = gFixture->io;
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(io.MoveAxis(CATCHER, 0.2 + Variant(i) * 0.01, CATCHER_PROFILE));
+}
+
+// Posting to an axis actor whose SDK calls do nothing: what a move costs the
+// control thread on a live rig, without the round trip the actor makes.
+class NullAxisDriver : public AxisDriver
+{
+public:
+    void Move(double, const MotionProfile &) override {}
+    void SetAmp(bool) override {}
+    void ClearFaults() override {}
+};
+
+void BenchActorMove(uint64_t iterations, bool repeat)
+{
+    RtConfig rt;
+    rt.policy = "other";
+    rt.prefaultStackKb = 0;
+    AxisActor actor(make_unique<NullAxisDriver>(), true);
+    actor.Start("hw-bench-axis", -1, rt);
+    for (uint64_t i = 0; i < iterations; i++)
+        DoNotOptimize(actor.Move(repeat ? 0.0 : 0.2 + Variant(i) * 0.01, CATCHER_PROFILE));
+    actor.Stop();
+}
+
+// Same target every time: left out before the queue.
+void BenchActorMoveRepeat(uint64_t iterations)
+{
+    BenchActorMove(iterations, true);
+}
+
+void BenchActorMoveNew(uint64_t iterations)
+{
+    BenchActorMove(iterations, false);
+}
+
+// === LOGGING ===
+// One of the verbose per-launch lines, formatted through iostreams.
+void BenchDebugLine(uint64_t iterations)
+{
+    ostream &out = gFixture->debugOut;
+    for (uint64_t i = 0; i < iterations; i++)
+        out << "[Physics] Speed: " << 2.0 + Variant(i) * 0.01 << " m/s | Landing: " << 0.4 << " m" << endl;
+}
+
+// One launch log row, %.17g formatting and the per-row flush.
+void BenchLaunchLogWrite(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++)
+        gFixture->log.Write(gFixture->record);
+}
+
+// === TELEMETRY ===
+void BenchMetricsPhase(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++)
+        MetricsPhase(PHASE_SENSOR1_WAIT, 1000 + static_cast<int64_t>(i % INPUT_VARIANTS));
+}
+
+void BenchJitterRecord(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++)
+        JitterRecord(20000 + static_cast<int64_t>(i % INPUT_VARIANTS), 3000);
+}
+
+void BenchStreamStatAdd(uint64_t iterations)
+{
+    StreamStat &stat = *gFixture->stat;
+    for (uint64_t i = 0; i < iterations; i++)
+        stat.Add(0.0005 + Variant(i) * 1e-5);
+}
+
+void BenchStatisticsSerialize(uint64_t iterations)
+{
+    vector<uint8_t> &blob = gFixture->blob;
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        blob.clear();
+        gFixture->statistics->Serialize(blob);
+        DoNotOptimize(blob.data());
+    }
+}
+
+// === RUNNER ===
+struct Benchmark
+{
+    const char *name;
+    void (*body)(uint64_t iterations);
+};
+
+const Benchmark BENCHMARKS[] = {
+    {"physics/ComputeSpeed", BenchComputeSpeed},
+    {"physics/ComputeTimeOfFlight", BenchComputeTimeOfFlight},
+    {"physics/ComputeLandingPosition", BenchComputeLandingPosition},
+    {"physics/ComputeMoveTime", BenchComputeMoveTime},
+    {"physics/PlanLaunch", BenchPlanLaunch},
+    {"physics/LandingCorrection::Apply", BenchLandingCorrection},
+    {"clock/clock_gettime", BenchClockGettime},
+    {"clock/steady_clock::now", BenchSteadyClock},
+    {"clock/MonotonicClock::NowNs", BenchMonotonicClock},
+    {"clock/TscClock::NowTicks", BenchTscTicks},
+    {"clock/TscClock::NowNs", BenchTscClock},
+    {"clock/GetClock().NowNs", BenchGetClockNow},
+    {"io/SensorLevel", BenchSensorLevel},
+    {"io/AxisActualPosition", BenchAxisActualPosition},
+    {"io/MotionDone", BenchMotionDone},
+    {"io/ReadStatus", BenchReadStatus},
+    {"io/MoveAxis", BenchMoveAxis},
+    {"io/AxisActor::Move (repeat)", BenchActorMoveRepeat},
+    {"io/AxisActor::Move (new target)", BenchActorMoveNew},
+    {"log/debug_line", BenchDebugLine},
+    {"log/LaunchLogWriter::Write", BenchLaunchLogWrite},
+    {"telemetry/MetricsPhase", BenchMetricsPhase},
+    {"telemetry/JitterRecord", BenchJitterRecord},
+    {"telemetry/StreamStat::Add", BenchStreamStatAdd},
+    {"telemetry/LaunchStatistics::Serialize", BenchStatisticsSerialize},
+};
+
+double TimeIterations(const Benchmark &benchmark, uint64_t iterations)
+{
+    auto start = chrono::steady_clock::now();
+    benchmark.body(iterations);
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Grows the iteration count until a run takes at least `minSeconds`, like
+// Google Benchmark, and reports the time per iteration of that last run.
+void RunBenchmark(const Benchmark &benchmark, double minSeconds)
+{
+    uint64_t iterations = 1;
+    double seconds = TimeIterations(benchmark, iterations);
+    while (seconds < minSeconds && iterations < (uint64_t(1) << 40))
+    {
+        // Aim 40% past the target so the final run usually clears it in one step.
+        double scale = seconds > 0.0 ? minSeconds * 1.4 / seconds : 10.0;
+        iterations = static_cast<uint64_t>(iterations * min(max(scale, 2.0), 10.0)) + 1;
+        seconds = TimeIterations(benchmark, iterations);
+    }
+    printf("%-40s %12.1f ns %14llu\n", benchmark.name, seconds * 1e9 / iterations, (unsigned long long)iterations);
+    fflush(stdout);
+}
+
+// === CLOCK DRIFT ===
+// Offset of two TSC clocks from CLOCK_MONOTONIC_RAW: one rechecked on its
+// normal period (as the control loops run it) and one left free-running on
+// its startup calibration.
+int RunDriftCheck(double seconds)
+{
+    printf("[Drift] Invariant TSC: %s\n", TscInvariant() ? "yes" : "no (TscClock reads CLOCK_MONOTONIC_RAW)");
+    TscClock rechecked;
+    TscClock freeRunning;
+    printf("[Drift] %.6f GHz after %lld ms calibration\n", rechecked.TicksPerSecond() * 1e-9,
+           (long long)(TSC_CALIBRATION_NS / NS_PER_MS));
+    printf("%10s %16s %16s %16s\n", "elapsed_s", "rechecked_ns", "free_ns", "ticks/s");
+
+    int64_t start = RawClockNs();
+    int64_t worstRechecked = 0, worstFree = 0;
+    while (RawClockNs() - start < SecondsToNs(seconds))
+    {
+        rechecked.SleepUntil(rechecked.NowNs() + DRIFT_SAMPLE_PERIOD_NS);
+        int64_t before = RawClockNs();
+        uint64_t ticks = TscClock::NowTicks();
+        int64_t after = RawClockNs();
+        int64_t raw = before + (after - before) / 2;
+        int64_t offset = rechecked.TicksToNs(ticks) - raw;
+        int64_t freeOffset = freeRunning.TicksToNs(ticks) - raw;
+        worstRechecked = max(worstRechecked, offset < 0 ? -offset : offset);
+        worstFree = max(worstFree, freeOffset < 0 ? -freeOffset : freeOffset);
+        printf("%10.1f %16lld %16lld %16.0f\n", (raw - start) * 1e-9, (long long)offset, (long long)freeOffset,
+               rechecked.TicksPerSecond());
+    }
+    printf("[Drift] Worst offset: %lld ns rechecked, %lld ns free-running\n", (long long)worstRechecked,
+           (long long)worstFree);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *filter = "";
+    double minSeconds = 0.5;
+    double driftSeconds = 0.0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            minSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+            driftSeconds = atof(argv[++i]);
+        else if (argv[i][0] != '-')
+            filter = argv[i];
+        else
+        {
+            fprintf(stderr, "usage: %s [filter] [-t <min seconds per benchmark>] [-d <drift check seconds>]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (driftSeconds > 0.0)
+        return RunDriftCheck(driftSeconds);
+
+    BenchFixture fixture;
+    gFixture = &fixture;
+
+    printf("%-40s %15s %14s\n", "benchmark", "time/op", "iterations");
+    for (const Benchmark &benchmark : BENCHMARKS)
+    {
+        if (strstr(benchmark.name, filter))
+            RunBenchmark(benchmark, minSeconds);
+    }
+    gFixture = nullptr;
+    return 0;
+}
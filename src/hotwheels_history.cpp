@@ -0,0 +1,226 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "angle_recommender.h"
+#include "launch_history.h"
+#include "launch_log.h"
+#include "params.h"
+
+using namespace std;
+
+// hotwheels-history: queries the launch history store written by HotWheelsDemo.
+//   hotwheels-history [options] info                      rows, blocks and time span
+//   hotwheels-history [options] stats [column...]         aggregates (default speed landing margin catcher_cmd)
+//   hotwheels-history [options] trend <column> [buckets]  drift over the matching launches
+//   hotwheels-history [options] angles                    per-angle speed priors
+//   hotwheels-history [options] recommend [catcher m]     angle scores from the current catcher position
+//   hotwheels-history [options] import <launches.csv>...  append launch logs to the store
+// options:
+//   -d <dir>          store directory (default hotwheels_history)
+//   -p <file>         parameters for recommend (default hotwheels_params.conf, built-in defaults if missing)
+//   -a <deg>          one angle bin          -A <min> <max>  angle range, deg
+//   -s <unix s>       launches since         -n <count>      newest launches only
+//   -r <rig>          one rig
+
+namespace
+{
+    void PrintUsage(const char *program)
+    {
+        fprintf(stderr,
+                "usage: %s [-d dir] [-a deg | -A min max] [-s since] [-n last] [-r rig] "
+                "[-p params] info | stats [column...] | trend <column> [buckets] | angles | recommend [catcher] | "
+                "import <csv>...\n",
+                program);
+    }
+
+    void PrintAggregateHeader(const char *label)
+    {
+        printf("%-16s %10s %12s %12s %12s %12s %12s %12s %12s\n", label, "count", "mean", "stddev", "min", "p50", "p95",
+               "p99", "max");
+    }
+
+    void PrintAggregate(const string &label, const HistoryAggregate &a)
+    {
+        printf("%-16s %10llu %12.6g %12.6g %12.6g %12.6g %12.6g %12.6g %12.6g\n", label.c_str(),
+               (unsigned long long)a.count, a.mean, a.stddev, a.min, a.p50, a.p95, a.p99, a.max);
+    }
+
+    double MillisecondsSince(chrono::steady_clock::time_point start)
+    {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+
+    int Import(const string &directory, const vector<string> &paths)
+    {
+        HistoryWriter writer;
+        if (!writer.Open(directory))
+            return 1;
+        uint64_t before = writer.Rows();
+        for (const string &path : paths)
+        {
+            vector<LaunchRecord> records;
+            if (!LaunchLogRead(path, records))
+            {
+                fprintf(stderr, "[History] Could not read %s\n", path.c_str());
+                return 1;
+            }
+            for (const LaunchRecord &record : records)
+                writer.Append(record, 0);
+            printf("[History] %s: %zu launches\n", path.c_str(), records.size());
+        }
+        printf("[History] %llu -> %llu launches in %s\n", (unsigned long long)before,
+               (unsigned long long)writer.Rows(), directory.c_str());
+        return 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    string directory = HISTORY_PATH;
+    string paramsPath = "hotwheels_params.conf";
+    HistoryQuery query;
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (hasValue && strcmp(argv[i], "-d") == 0)
+            directory = argv[++i];
+        else if (hasValue && strcmp(argv[i], "-p") == 0)
+            paramsPath = argv[++i];
+        else if (hasValue && strcmp(argv[i], "-a") == 0)
+        {
+            double angle = atof(argv[++i]);
+            query.angleMin = angle - PRIOR_BIN_DEG / 2.0;
+            query.angleMax = angle + PRIOR_BIN_DEG / 2.0;
+        }
+        else if (i + 2 < argc && strcmp(argv[i], "-A") == 0)
+        {
+            query.angleMin = atof(argv[++i]);
+            query.angleMax = atof(argv[++i]);
+        }
+        else if (hasValue && strcmp(argv[i], "-s") == 0)
+            query.timeMin = atof(argv[++i]);
+        else if (hasValue && strcmp(argv[i], "-n") == 0)
+            query.last = strtoull(argv[++i], nullptr, 10);
+        else if (hasValue && strcmp(argv[i], "-r") == 0)
+            query.rig = atoi(argv[++i]);
+        else
+        {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (i == argc)
+    {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    string command = argv[i++];
+    vector<string> args(argv + i, argv + argc);
+
+    if (command == "import")
+    {
+        if (args.empty())
+        {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+        return Import(directory, args);
+    }
+
+    auto start = chrono::steady_clock::now();
+    HistoryReader reader;
+    if (!reader.Open(directory))
+    {
+        fprintf(stderr, "[History] No store at %s\n", directory.c_str());
+        return 1;
+    }
+
+    if (command == "info")
+    {
+        printf("%s: %llu launches in %llu blocks of %u\n", directory.c_str(), (unsigned long long)reader.Rows(),
+               (unsigned long long)reader.BlockCount(), HISTORY_BLOCK_ROWS);
+        if (reader.Rows() > 0)
+        {
+            HistoryAggregate time = HistoryAggregateColumn(reader, COL_WALL_TIME, HistoryQuery{});
+            printf("wall time %.0f .. %.0f (%.1f days)\n", time.min, time.max, (time.max - time.min) / 86400.0);
+        }
+    }
+    else if (command == "stats")
+    {
+        if (args.empty())
+            args = {"speed", "landing", "margin", "catcher_cmd"};
+        PrintAggregateHeader("column");
+        for (const string &name : args)
+        {
+            int column = HistoryColumnByName(name);
+            if (column < 0)
+            {
+                fprintf(stderr, "[History] Unknown column %s\n", name.c_str());
+                return 2;
+            }
+            PrintAggregate(name, HistoryAggregateColumn(reader, static_cast<HistoryColumn>(column), query));
+        }
+    }
+    else if (command == "trend" && !args.empty())
+    {
+        int column = HistoryColumnByName(args[0]);
+        if (column < 0)
+        {
+            fprintf(stderr, "[History] Unknown column %s\n", args[0].c_str());
+            return 2;
+        }
+        int buckets = args.size() > 1 ? atoi(args[1].c_str()) : 10;
+        double slope = 0.0;
+        vector<HistoryAggregate> trend = HistoryTrend(reader, static_cast<HistoryColumn>(column), query, buckets, slope);
+        PrintAggregateHeader("bucket");
+        for (size_t b = 0; b < trend.size(); b++)
+            PrintAggregate(to_string(b), trend[b]);
+        printf("slope %.6g %s per launch\n", slope, args[0].c_str());
+    }
+    else if (command == "angles")
+    {
+        SpeedPriors priors = HistorySpeedPriors(reader, query);
+        printf("%8s %10s %12s %12s\n", "angle", "count", "speed_mean", "speed_std");
+        for (int b = 0; b < PRIOR_BINS; b++)
+        {
+            const AnglePrior &prior = priors.bins[b];
+            if (prior.count > 0)
+                printf("%8.1f %10u %12.5f %12.5f\n", b * PRIOR_BIN_DEG, prior.count, prior.meanSpeed, prior.speedStdDev);
+        }
+    }
+    else if (command == "recommend")
+    {
+        Params params;
+        string error;
+        if (!ParamsLoadFile(paramsPath, params, error))
+            params = Params{};
+        double catcher = args.empty() ? params.launch.minCatcherPosition : atof(args[0].c_str());
+        vector<AngleScore> scores;
+        ScoreAngles(HistorySpeedPriors(reader, query), catcher, RECOMMEND_COMMAND_DELAY, params.launch, scores);
+        int pick = PickAngle(scores);
+        printf("%8s %10s %10s %9s %11s %11s\n", "angle", "speed", "speed_std", "catch_%", "timing_ms", "position_m");
+        for (int s = 0; s < static_cast<int>(scores.size()); s++)
+        {
+            const AngleScore &score = scores[s];
+            if (s != pick && lround(score.angle / RECOMMEND_ANGLE_STEP) % 10 != 0)
+                continue; // whole degrees plus the pick
+            printf("%8.1f %10.4f %10.4f %9.2f %11.1f %11.3f%s\n", score.angle + params.launch.angleOffset, score.speed,
+                   score.speedStdDev, score.catchProbability * 100.0, score.timingMargin * 1000.0, score.positionMargin,
+                   s == pick ? "  <- pick" : "");
+        }
+        if (pick < 0)
+            fprintf(stderr, "[History] Not enough launches at any angle (%u per bin needed)\n", RECOMMEND_MIN_LAUNCHES);
+    }
+    else
+    {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    fprintf(stderr, "[History] %.2f ms over %llu launches\n", MillisecondsSince(start), (unsigned long long)reader.Rows());
+    return 0;
+}
@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "launch_history.h"
+
+using namespace std;
+
+// hotwheels_history_test: writes a history store in two sessions with a torn
+// row in between, reopens it and checks the scans, aggregates and speed
+// priors against a brute-force pass over the rows that were appended.
+//   hotwheels_history_test [store directory]
+
+constexpr const char *TEST_STORE_PATH = "history_test_store"; // removed before and after the run
+constexpr int FIRST_SESSION_ROWS = 10000;  // spans the first three index blocks
+constexpr int SECOND_SESSION_ROWS = 3000;
+constexpr double TEST_START_TIME = 1.7e9;  // unix s of the first row
+constexpr double TEST_ROW_SECONDS = 2.0;
+
+namespace
+{
+    int failures = 0;
+
+    void Check(bool ok, const string &what)
+    {
+        if (!ok)
+        {
+            fprintf(stderr, "[Test] FAILED: %s\n", what.c_str());
+            failures++;
+        }
+    }
+
+    struct Row
+    {
+        LaunchRecord record;
+        int rig = 0;
+    };
+
+    // Each index block sweeps its own 20° band, so angle queries can skip whole blocks.
+    Row MakeRow(int index, mt19937 &rng)
+    {
+        uniform_real_distribution<double> unit(0.0, 1.0);
+        Row row;
+        LaunchRecord &r = row.record;
+        r.wallTime = TEST_START_TIME + index * TEST_ROW_SECONDS;
+        r.angle = 10.0 * (index / HISTORY_BLOCK_ROWS) + 20.0 * unit(rng);
+        r.speed = 1.5 + r.angle * 0.01 + 0.1 * unit(rng);
+        r.landing = 0.3 + r.speed * 0.2;
+        r.catcherCmd = 0.0005;
+        r.feasible = unit(rng) < 0.9;
+        double outcome = unit(rng);
+        r.outcome = outcome < 0.7 ? CATCH_CAUGHT : outcome < 0.9 ? CATCH_MISSED : CATCH_UNKNOWN;
+        r.impactPosition = r.outcome == CATCH_CAUGHT ? r.landing + 0.02 * (unit(rng) - 0.5) : 0.0;
+        row.rig = index % 3;
+        return row;
+    }
+
+    bool Matches(const Row &row, const HistoryQuery &query)
+    {
+        const LaunchRecord &r = row.record;
+        return r.angle >= query.angleMin && r.angle <= query.angleMax && r.wallTime >= query.timeMin &&
+               r.wallTime <= query.timeMax && (query.rig < 0 || row.rig == query.rig);
+    }
+
+    // The rows the query should select, by brute force over everything appended.
+    vector<uint64_t> Expected(const vector<Row> &rows, const HistoryQuery &query)
+    {
+        uint64_t first = (query.last && query.last < rows.size()) ? rows.size() - query.last : 0;
+        vector<uint64_t> selected;
+        for (uint64_t i = first; i < rows.size(); i++)
+        {
+            if (Matches(rows[i], query))
+                selected.push_back(i);
+        }
+        return selected;
+    }
+
+    HistoryAggregate BruteAggregate(vector<double> values)
+    {
+        HistoryAggregate result;
+        result.count = values.size();
+        if (values.empty())
+            return result;
+        double sum = 0.0, squares = 0.0;
+        for (double v : values)
+            sum += v;
+        result.mean = sum / values.size();
+        for (double v : values)
+            squares += (v - result.mean) * (v - result.mean);
+        result.stddev = values.size() > 1 ? sqrt(squares / (values.size() - 1)) : 0.0;
+        sort(values.begin(), values.end());
+        auto at = [&](double q) { return values[static_cast<size_t>(llround(q * (values.size() - 1)))]; };
+        result.min = values.front();
+        result.max = values.back();
+        result.p50 = at(0.50);
+        result.p95 = at(0.95);
+        result.p99 = at(0.99);
+        return result;
+    }
+
+    bool Near(double a, double b)
+    {
+        return fabs(a - b) <= 1e-9 * max(1.0, fabs(b));
+    }
+
+    void CheckQuery(const HistoryReader &reader, const vector<Row> &rows, const HistoryQuery &query, const string &name)
+    {
+        vector<uint64_t> expected = Expected(rows, query);
+        vector<uint64_t> scanned;
+        HistoryScan(reader, query, [&](uint64_t row) { scanned.push_back(row); });
+        Check(scanned == expected, name + ": scan selects " + to_string(scanned.size()) + " rows, brute force " +
+                                       to_string(expected.size()));
+
+        // One column of each width, plus the landing error, which only caught launches have.
+        vector<double> speeds, outcomes, landingErrors;
+        for (uint64_t i : expected)
+        {
+            const LaunchRecord &r = rows[i].record;
+            speeds.push_back(r.speed);
+            outcomes.push_back((r.feasible ? OUTCOME_FEASIBLE : 0) | (r.outcome == CATCH_CAUGHT ? OUTCOME_CAUGHT : 0) |
+                               (r.outcome == CATCH_MISSED ? OUTCOME_MISSED : 0));
+            if (r.outcome == CATCH_CAUGHT)
+                landingErrors.push_back(r.impactPosition - r.landing);
+        }
+        const pair<HistoryColumn, vector<double> *> columns[] = {
+            {COL_SPEED, &speeds}, {COL_OUTCOME, &outcomes}, {COL_LANDING_ERROR, &landingErrors}};
+        for (const auto &[column, values] : columns)
+        {
+            HistoryAggregate got = HistoryAggregateColumn(reader, column, query);
+            HistoryAggregate want = BruteAggregate(*values);
+            string label = name + " " + HISTORY_COLUMN_INFO[column].name;
+            Check(got.count == want.count, label + " count");
+            Check(Near(got.mean, want.mean) && Near(got.stddev, want.stddev), label + " mean/stddev");
+            Check(got.min == want.min && got.max == want.max, label + " min/max");
+            Check(got.p50 == want.p50 && got.p95 == want.p95 && got.p99 == want.p99, label + " percentiles");
+        }
+    }
+
+    void CheckPriors(const SpeedPriors &got, const SpeedPriors &want, const string &name)
+    {
+        Check(got.launches == want.launches, name + " launch count");
+        for (int b = 0; b < PRIOR_BINS; b++)
+        {
+            Check(got.bins[b].count == want.bins[b].count && Near(got.bins[b].meanSpeed, want.bins[b].meanSpeed) &&
+                      Near(got.bins[b].speedStdDev, want.bins[b].speedStdDev),
+                  name + " bin " + to_string(b));
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    string directory = argc > 1 ? argv[1] : TEST_STORE_PATH;
+    filesystem::remove_all(directory);
+
+    mt19937 rng(42);
+    vector<Row> rows;
+    HistoryWriter writer;
+    Check(writer.Open(directory), "create the store");
+    for (int i = 0; i < FIRST_SESSION_ROWS; i++)
+    {
+        rows.push_back(MakeRow(i, rng));
+        writer.Append(rows.back().record, rows.back().rig);
+    }
+    writer.Close();
+
+    // A crash part way through an append: half a value in one column.
+    int fd = open((directory + "/speed.col").c_str(), O_WRONLY | O_APPEND);
+    Check(fd >= 0 && write(fd, "torn", 4) == 4, "tear the last row");
+    if (fd >= 0)
+        close(fd);
+    HistoryReader reader;
+    Check(reader.Open(directory) && reader.Rows() == FIRST_SESSION_ROWS, "a torn row is not read");
+    reader.Close();
+
+    Check(writer.Open(directory) && writer.Rows() == FIRST_SESSION_ROWS, "reopen the store");
+    for (int i = FIRST_SESSION_ROWS; i < FIRST_SESSION_ROWS + SECOND_SESSION_ROWS; i++)
+    {
+        rows.push_back(MakeRow(i, rng));
+        writer.Append(rows.back().record, rows.back().rig);
+    }
+    writer.Close();
+
+    if (!reader.Open(directory))
+    {
+        fprintf(stderr, "[Test] FAILED: could not open %s\n", directory.c_str());
+        return 1;
+    }
+    Check(reader.Rows() == rows.size(), "row count after reopening");
+    Check(reader.BlockCount() == (rows.size() + HISTORY_BLOCK_ROWS - 1) / HISTORY_BLOCK_ROWS, "one index entry per block");
+    for (uint64_t i = 0; i < min<uint64_t>(reader.Rows(), rows.size()); i++)
+    {
+        const LaunchRecord &r = rows[i].record;
+        if (reader.Doubles(COL_ANGLE)[i] != r.angle || reader.Doubles(COL_SPEED)[i] != r.speed ||
+            reader.Doubles(COL_WALL_TIME)[i] != r.wallTime || reader.Bytes(COL_RIG)[i] != rows[i].rig)
+        {
+            Check(false, "row " + to_string(i) + " reads back as written");
+            break;
+        }
+    }
+
+    double middle = TEST_START_TIME + rows.size() * TEST_ROW_SECONDS / 2.0;
+    HistoryQuery all, angle, time, rig, last, combined;
+    angle.angleMin = 12.0;
+    angle.angleMax = 18.0;
+    time.timeMin = middle;
+    rig.rig = 1;
+    last.last = 5000;
+    combined.angleMin = 25.0;
+    combined.angleMax = 40.0;
+    combined.timeMax = middle;
+    combined.rig = 2;
+    combined.last = 9000;
+    CheckQuery(reader, rows, all, "all rows");
+    CheckQuery(reader, rows, angle, "angle 12-18");
+    CheckQuery(reader, rows, time, "second half");
+    CheckQuery(reader, rows, rig, "rig 1");
+    CheckQuery(reader, rows, last, "last 5000");
+    CheckQuery(reader, rows, combined, "combined");
+
+    // The priors from a scan, and folded in one launch at a time.
+    SpeedPriors folded;
+    for (const Row &row : rows)
+        folded.Add(row.record.angle, row.record.speed);
+    CheckPriors(HistorySpeedPriors(reader), folded, "speed priors");
+    SpeedPriors angleFolded;
+    for (uint64_t i : Expected(rows, angle))
+        angleFolded.Add(rows[i].record.angle, rows[i].record.speed);
+    CheckPriors(HistorySpeedPriors(reader, angle), angleFolded, "angle 12-18 speed priors");
+
+    reader.Close();
+    filesystem::remove_all(directory);
+    if (failures)
+    {
+        fprintf(stderr, "[Test] %d checks failed\n", failures);
+        return 1;
+    }
+    printf("[Test] %zu launches: scans, aggregates and speed priors match brute force\n", rows.size());
+    return 0;
+}
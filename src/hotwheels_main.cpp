@@ -1,144 +1,219 @@
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <chrono>
 #include <thread>
 #include <cmath>
 #include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
 #include "SampleAppsHelper.h"
 #include "rsi.h"
+#include "axis_trace.h"
+#include "launch_history.h"
+#include "launch_log.h"
+#include "launch_pipeline.h"
+#include "metrics.h"
+#include "span_trace.h"
+#include "params.h"
+#include "profile_tuner.h"
+#include "axis_actor.h"
+#include "angle_recommender.h"
+#include "rig.h"
+#include "rt_setup.h"
+#include "status_block.h"
 
 using namespace RSI::RapidCode;
 using namespace std;
 
 // === CONSTANTS ===
-constexpr double SENSOR_DISTANCE = 0.1; // meters
-constexpr double ANGLE_OFFSET = 0;      // degrees
-constexpr double GRAVITY = 9.81;
-constexpr double UNITS_PER_DEGREE = 186413.5111;
-constexpr double UNITS_PER_METER = 8532248;
-constexpr double MIN_CATCHER_POSITION = 0;
-constexpr double MAX_CATCHER_POSITION = 0.84;
-constexpr double RAMP_HEIGHT = 0.23; //relative to catcher
-constexpr bool DEBUG_MODE = true;
-
-// === ENUMS ===
-enum AxisID
-{
-    RAMP = 0,
-    DOOR = 1,
-    CATCHER = 2
-};
+constexpr bool TRACE_MODE = true; // record axis/sensor traces around each launch
+constexpr const char *PARAMS_PATH = "hotwheels_params.conf";
+constexpr const char *LAUNCH_LOG_PATH = "hotwheels_launches.csv";
+constexpr const char *SPAN_TRACE_PATH = "hotwheels_spans.json"; // only written with HOTWHEELS_TRACE_SPANS
 
 // === GLOBALS ===
 MotionController *controller = nullptr;
-Axis *motorRamp = nullptr;
-Axis *motorDoor = nullptr;
-Axis *motorCatcher = nullptr;
-IOPoint *sensor1Input = nullptr;
-IOPoint *sensor2Input = nullptr;
+
+// Controller objects for one rig. Filled in by SetupRMP, read-only afterwards.
+// Once the actors exist, axis commands go through them only.
+struct RmpRig
+{
+    Axis *axes[AXIS_COUNT] = {};
+    IOPoint *sensors[2] = {}; // sensor 1, sensor 2
+    unique_ptr<AxisActor> actors[AXIS_COUNT];
+};
+RmpRig gRigs[MAX_RIGS];
+int gRigCount = 0;
 
 volatile sig_atomic_t gShutdown = 0;
 
+// What the signal handler may touch: each actor is published here once it has
+// started and withdrawn before it stops.
+atomic<AxisActor *> gSignalActors[MAX_RIGS][AXIS_COUNT] = {};
+
+HistoryWriter gHistory; // every completed launch of every rig, kept across runs
+
 // === SIGNAL HANDLING ===
+// The axis actors turn the amps off; the handler itself makes no SDK call and
+// only uses async-signal-safe calls.
 void SignalHandler(int signal)
 {
-    cout << "[Signal] Shutdown requested." << endl;
+    static const char message[] = "[Signal] Shutdown requested.\n";
+    ssize_t ignored = write(STDOUT_FILENO, message, sizeof(message) - 1);
+    (void)ignored;
     gShutdown = 1;
-    if (motorRamp)
-        motorRamp->AmpEnableSet(false);
-    if (motorDoor)
-        motorDoor->AmpEnableSet(false);
-    if (motorCatcher)
-        motorCatcher->AmpEnableSet(false);
+    for (auto &rig : gSignalActors)
+    {
+        for (atomic<AxisActor *> &slot : rig)
+        {
+            if (AxisActor *actor = slot.load(memory_order_acquire))
+                actor->RequestDisable();
+        }
+    }
 }
 
 // === RMP SETUP ===
-void InitMotor(Axis *axis)
+// Writes a setting only when the controller holds a different value, so a warm
+// start over an already configured axis costs reads instead of writes.
+template <typename T, typename Setter>
+int ApplySetting(T current, T wanted, Setter set)
 {
-    if (axis == motorCatcher){
-        axis->UserUnitsSet(UNITS_PER_METER);
-    }
-    else{
-        axis->UserUnitsSet(UNITS_PER_DEGREE);
-    }
-    axis->ErrorLimitTriggerValueSet(0.5);
-    axis->ErrorLimitActionSet(RSIAction::RSIActionNONE);
+    if (current == wanted)
+        return 0;
+    set(wanted);
+    return 1;
+}
 
-    axis->HardwareNegLimitTriggerStateSet(1);
-    axis->HardwarePosLimitTriggerStateSet(1);
-    axis->HardwareNegLimitActionSet(RSIAction::RSIActionNONE);
-    axis->HardwarePosLimitActionSet(RSIAction::RSIActionNONE);
-    axis->HardwareNegLimitDurationSet(2);
-    axis->HardwarePosLimitDurationSet(2);
-    axis->PositionSet(0);
-    if(axis == motorCatcher){
-        axis->HomeActionSet(RSIAction::RSIActionDONE);
+// Configures one axis from its entry in the rig description. Returns the
+// number of settings that actually had to be written.
+template <AxisID Role>
+int InitMotor(Axis *axis, bool warmStart)
+{
+    constexpr const AxisDescription &description = DemoRig::Axis(Role);
+    [[maybe_unused]] static const char *const spanNames[AXIS_COUNT] = {"InitMotor ramp", "InitMotor door", "InitMotor catcher"};
+    TRACE_SPAN(spanNames[Role]);
+    int writes = 0;
+    writes += ApplySetting(axis->UserUnitsGet(), description.countsPerUnit, [axis](double v) { axis->UserUnitsSet(v); });
+    // Following error past the limit aborts the axis: the amp drops and the
+    // axis stays in ERROR until its faults are cleared (fault_supervisor.h).
+    writes += ApplySetting(axis->ErrorLimitTriggerValueGet(), description.errorLimit, [axis](double v) { axis->ErrorLimitTriggerValueSet(v); });
+    writes += ApplySetting(axis->ErrorLimitActionGet(), RSIAction::RSIActionABORT, [axis](RSIAction v) { axis->ErrorLimitActionSet(v); });
+
+    writes += ApplySetting(axis->HardwareNegLimitTriggerStateGet(), true, [axis](bool v) { axis->HardwareNegLimitTriggerStateSet(v); });
+    writes += ApplySetting(axis->HardwarePosLimitTriggerStateGet(), true, [axis](bool v) { axis->HardwarePosLimitTriggerStateSet(v); });
+    writes += ApplySetting(axis->HardwareNegLimitActionGet(), RSIAction::RSIActionNONE, [axis](RSIAction v) { axis->HardwareNegLimitActionSet(v); });
+    writes += ApplySetting(axis->HardwarePosLimitActionGet(), RSIAction::RSIActionNONE, [axis](RSIAction v) { axis->HardwarePosLimitActionSet(v); });
+    writes += ApplySetting(axis->HardwareNegLimitDurationGet(), 2.0, [axis](double v) { axis->HardwareNegLimitDurationSet(v); });
+    writes += ApplySetting(axis->HardwarePosLimitDurationGet(), 2.0, [axis](double v) { axis->HardwarePosLimitDurationSet(v); });
+
+    // A running network still holds a valid position reference; only zero it on a cold start.
+    if (!warmStart)
+    {
+        axis->PositionSet(0);
+        writes++;
+    }
+    if constexpr (description.homeOnStart)
+    {
+        writes += ApplySetting(axis->HomeActionGet(), RSIAction::RSIActionDONE, [axis](RSIAction v) { axis->HomeActionSet(v); });
     }
 
     axis->ClearFaults();
-    axis->AmpEnableSet(true);
+    writes += ApplySetting(axis->AmpEnableGet(), true, [axis](bool v) { axis->AmpEnableSet(v); });
+    return writes;
 }
 
-void MoveSCurve(Axis *axis, double pos)
+using InitMotorFn = int (*)(Axis *, bool);
+constexpr InitMotorFn INIT_MOTOR[AXIS_COUNT] = {InitMotor<RAMP>, InitMotor<DOOR>, InitMotor<CATCHER>};
+
+// The SDK calls an axis actor makes for one RMP axis.
+class RmpAxisDriver : public AxisDriver
 {
-    try
+public:
+    explicit RmpAxisDriver(Axis *axis) : axis(axis) {}
+
+    void Move(double target, const MotionProfile &profile) override
     {
-        //  Motion parameters — tune as needed
-        double velocity = 50.0;      // deg/sec
-        double acceleration = 300.0; // deg/sec²
-        double deceleration = 300.0; // deg/sec²
-        double jerkPercent = 0.0;    // 0 = trapezoidal
-        if (axis == motorDoor)
-        {
-            //  Motion parameters for Door— tune as needed
-            velocity = 100000.0;     // deg/sec
-            acceleration = 300000.0; // deg/sec²
-            deceleration = 300000.0; // deg/sec²
-            jerkPercent = 0.0;       // 0 = trapezoidal
-        }
-        if (axis == motorCatcher){
-            cout << "[Catcher] Moving Catcher\n";
-            //  Motion parameters for Catcher—tune as needed
-            velocity = 20.0;     // m/sec
-            acceleration = 75.0; // m/sec²
-            deceleration = 75.0; // m/sec²
-            jerkPercent = 0.0;       // 0 = trapezoidal
-        }
-        axis->MoveSCurve(pos, velocity, acceleration, deceleration, jerkPercent);
+        axis->MoveSCurve(target, profile.velocity, profile.acceleration, profile.deceleration, profile.jerkPercent);
     }
-    catch (const std::exception &e)
+
+    void SetAmp(bool enabled) override
     {
-        cerr << "[Error] Move failed: " << e.what() << endl;
+        axis->AmpEnableSet(enabled);
     }
-}
+
+    void ClearFaults() override
+    {
+        axis->ClearFaults();
+    }
+
+private:
+    Axis *axis;
+};
 
 void SetupRMP()
 {
+    Clock &clock = GetClock();
+    int64_t setupStart = clock.NowNs();
+    int64_t phaseStart = setupStart;
+    auto elapsedMs = [&clock](int64_t since) { return (clock.NowNs() - since) / 1e6; };
+
     MotionController::CreationParameters p;
     strncpy(p.RmpPath, "/rsi/", p.PathLengthMaximum);
-    strncpy(p.NicPrimary, "enp6s0", p.PathLengthMaximum);
-    p.CpuAffinity = 3;
+    strncpy(p.NicPrimary, ParamsStartup().nicPrimary.c_str(), p.PathLengthMaximum);
+    p.CpuAffinity = ParamsStartup().cpuAffinity;
 
     controller = MotionController::Create(&p);
     SampleAppsHelper::CheckErrors(controller);
+    double createMs = elapsedMs(phaseStart);
 
-    SampleAppsHelper::StartTheNetwork(controller);
-
-    // Motor setup
-    motorRamp = controller->AxisGet(RAMP);
-    motorDoor = controller->AxisGet(DOOR);
-    motorCatcher = controller->AxisGet(CATCHER);
-    InitMotor(motorCatcher);
-    InitMotor(motorRamp);
-    InitMotor(motorDoor);
+    // Warm start: a previous run left the EtherCAT network operational, so attach instead of restarting it.
+    phaseStart = clock.NowNs();
+    bool warmStart = controller->NetworkStateGet() == RSINetworkState::RSINetworkStateOPERATIONAL;
+    if (!warmStart)
+    {
+        TRACE_SPAN("StartTheNetwork");
+        SampleAppsHelper::StartTheNetwork(controller);
+    }
+    double networkMs = elapsedMs(phaseStart);
+
+    // Motor setup, one axis at a time: nothing in the RapidCode documentation
+    // says Axis objects of one controller may be configured from several
+    // threads at once. A warm start still only pays for the reads.
+    const Params &startup = ParamsStartup();
+    gRigCount = startup.rigCount;
+    for (int r = 0; r < gRigCount; r++)
+    {
+        for (int a = 0; a < AXIS_COUNT; a++)
+            gRigs[r].axes[a] = controller->AxisGet(startup.rigs[r].axisNumbers[a]);
+    }
+    double axisMs[MAX_RIGS][AXIS_COUNT] = {};
+    int axisWrites[MAX_RIGS][AXIS_COUNT] = {};
+    phaseStart = clock.NowNs();
+    for (int r = 0; r < gRigCount; r++)
+    {
+        for (int a = 0; a < AXIS_COUNT; a++)
+        {
+            int64_t start = clock.NowNs();
+            axisWrites[r][a] = INIT_MOTOR[a](gRigs[r].axes[a], warmStart);
+            axisMs[r][a] = elapsedMs(start);
+        }
+    }
+    double motorsMs = elapsedMs(phaseStart);
     cout << "[RMP] Motors initialized.\n";
 
+    phaseStart = clock.NowNs();
     try
     {
-        int sensorNodeIndex = 1; // AKD = second node on the network
+        for (int r = 0; r < gRigCount; r++)
+        {
+            const RigConfig &rig = startup.rigs[r];
 
-        // ✅ Create IOPoint from network node (not axis)
-        sensor1Input = IOPoint::CreateDigitalInput(controller->NetworkNodeGet(sensorNodeIndex), 1); // Input 1
-        sensor2Input = IOPoint::CreateDigitalInput(controller->NetworkNodeGet(sensorNodeIndex), 0); // Input 0
+            // ✅ Create IOPoint from network node (not axis)
+            gRigs[r].sensors[0] = IOPoint::CreateDigitalInput(controller->NetworkNodeGet(rig.sensorNode), rig.sensorInputs[0]);
+            gRigs[r].sensors[1] = IOPoint::CreateDigitalInput(controller->NetworkNodeGet(rig.sensorNode), rig.sensorInputs[1]);
+        }
 
         cout << "[I/O] Digital inputs created successfully.\n";
     }
@@ -147,70 +222,485 @@ void SetupRMP()
         cerr << "[ERROR] Failed to create digital inputs: " << e.what() << endl;
         exit(1);
     }
+    double ioMs = elapsedMs(phaseStart);
+
+    cout << "[Startup] " << (warmStart ? "Warm start (network already operational)" : "Cold start") << "\n";
+    cout << "[Startup]   Create controller: " << createMs << " ms\n";
+    cout << "[Startup]   Network " << (warmStart ? "attach" : "start") << ": " << networkMs << " ms\n";
+    for (int r = 0; r < gRigCount; r++)
+    {
+        for (int a = 0; a < AXIS_COUNT; a++)
+            cout << "[Startup]   InitMotor rig " << r << " " << AXIS_NAMES[a] << ": " << axisMs[r][a] << " ms, "
+                 << axisWrites[r][a] << " writes\n";
+    }
+    cout << "[Startup]   All motors: " << motorsMs << " ms\n";
+    cout << "[Startup]   Digital inputs: " << ioMs << " ms\n";
+    cout << "[Startup]   Total: " << elapsedMs(setupStart) << " ms\n";
+
+    // The axis trace uses one recorder, so it follows rig 0.
+    if (TRACE_MODE)
+    {
+        if (!AxisTraceStart(controller, gRigs[0].axes, AXIS_COUNT, gRigs[0].sensors[0], gRigs[0].sensors[1], AxisTraceConfig{}))
+            cerr << "[Trace] Axis trace disabled.\n";
+    }
 }
 
-double ReadSensor(IOPoint *sensorInput)
+// === LIVE LAUNCH I/O ===
+// SDK calls are the only place the launch path can throw; each one is caught
+// here and turned into an IoError, with the message copied into a fixed buffer
+// so nothing allocates until the launch reports it. Axis commands go to the
+// rig's axis actors; reads are made here.
+class RmpLaunchIO : public LaunchIO
 {
+public:
+    explicit RmpLaunchIO(int rig) : rig(rig), axes(gRigs[rig].axes), sensors(gRigs[rig].sensors), actors(gRigs[rig].actors)
+    {
+        PlanStatusBlock();
+    }
 
-    if (!sensorInput)
+    IoResult<bool> SensorLevel(int sensor) override
     {
-        cerr << "[ERROR] Sensor pointer is null.\n";
-        return 0.0;
+        IOPoint *sensorInput = sensors[sensor - 1];
+        if (!sensorInput)
+            return {false, Fail(IO_SENSOR_READ, "sensor pointer is null")};
+        try
+        {
+            return {sensorInput->Get()};
+        }
+        catch (const std::exception &ex)
+        {
+            return {false, Fail(IO_SENSOR_READ, ex.what())};
+        }
     }
 
-    auto start = chrono::steady_clock::now();
+    // Returns once the actor has the move; a repeat of the last target costs nothing.
+    IoError MoveAxis(AxisID axis, double pos, const MotionProfile &profile) override
+    {
+        targetCounts[axis] = DemoRig::ToCounts(axis, pos + originOffset[axis]);
+        return ActorResult(axis, actors[axis]->Move(pos, profile));
+    }
+
+    IoResult<double> AxisActualPosition(AxisID axis) override
+    {
+        try
+        {
+            return {axes[axis]->ActualPositionGet()};
+        }
+        catch (const std::exception &e)
+        {
+            return {0.0, Fail(IO_POSITION_READ, e.what())};
+        }
+    }
 
-    while (true)
+    IoResult<bool> MotionDone(AxisID axis) override
     {
+        // A move still in the actor's queue has not started, so the axis is not done with it.
+        if (actors[axis]->Busy())
+            return {false};
         try
         {
-            bool val = sensorInput->Get();
-            if (DEBUG_MODE)
+            return {axes[axis]->MotionDoneGet()};
+        }
+        catch (const std::exception &e)
+        {
+            return {true, Fail(IO_MOTION_STATE_READ, e.what())};
+        }
+    }
+
+    // One MemoryBlockGet per planned span (normally one) instead of an SDK call
+    // per input and axis value, all from the same controller sample when it is one span.
+    IoError ReadStatus(StatusSnapshot &status) override
+    {
+        if (!statusPlanned)
+        {
+            IoError error = LaunchIO::ReadStatus(status);
+            // The catch detector needs the catcher's following error and drive output either way.
+            try
             {
-                cout << "[Debug] Sensor value: " << val << endl;
+                status.followingError[CATCHER] = axes[CATCHER]->PositionErrorGet();
+                status.filterOutput[CATCHER] = axes[CATCHER]->FilterOutputGet();
             }
-            if (val == 0.0)
+            catch (const std::exception &e)
             {
-                return 0.0;
+                return Fail(IO_POSITION_READ, e.what());
             }
-            return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+            return error;
         }
-        catch (const std::exception &ex)
+        try
+        {
+            for (int s = 0; s < statusBlock.SpanCount(); s++)
+                controller->MemoryBlockGet(statusBlock.SpanAddress(s), statusBlock.SpanData(s), statusBlock.SpanBytes(s));
+        }
+        catch (const std::exception &e)
+        {
+            return Fail(IO_STATUS_READ, e.what());
+        }
+        DecodeStatus(status);
+        return IO_OK;
+    }
+
+    bool Aborted() override
+    {
+        return gShutdown;
+    }
+
+    const char *ErrorDetail() override
+    {
+        return errorDetail;
+    }
+
+    void LaunchBegin(uint32_t launchId) override
+    {
+        if (rig == 0)
+            AxisTraceWindowBegin(launchId);
+    }
+
+    void LaunchEnd() override
+    {
+        if (rig == 0)
+            AxisTraceWindowEnd();
+    }
+
+    IoResult<AxisHealth> ReadAxisHealth(AxisID axis) override
+    {
+        try
+        {
+            RSIState state = axes[axis]->StateGet();
+            AxisHealth health;
+            health.fault = state == RSIState::RSIStateERROR || state == RSIState::RSIStateSTOPPING_ERROR;
+            health.ampEnabled = axes[axis]->AmpEnableGet();
+            return {health};
+        }
+        catch (const std::exception &e)
+        {
+            return {AxisHealth{true, false}, Fail(IO_MOTION_STATE_READ, e.what())};
+        }
+    }
+
+    IoError ClearAxisFault(AxisID axis) override
+    {
+        tripped[axis] = false;
+        return ActorResult(axis, actors[axis]->ClearFaults());
+    }
+
+    IoError EnableAxis(AxisID axis) override
+    {
+        return ActorResult(axis, actors[axis]->SetAmp(true));
+    }
+
+    // Clearing a fault drops the command position onto the actual one; the
+    // block decode compares against the last commanded target, so re-sync it.
+    IoError ReferenceAxis(AxisID axis) override
+    {
+        try
+        {
+            targetCounts[axis] = DemoRig::ToCounts(axis, axes[axis]->CommandPositionGet() + originOffset[axis]);
+            return IO_OK;
+        }
+        catch (const std::exception &e)
         {
-            cerr << "[ERROR] Sensor read failed: " << ex.what() << " | Pointer: " << sensorInput << endl;
-            return 0.0;
+            return Fail(IO_POSITION_READ, e.what());
         }
+    }
 
-        if (chrono::steady_clock::now() - start > chrono::seconds(5))
+private:
+    IoError Fail(IoError error, const char *message)
+    {
+        strncpy(errorDetail, message, sizeof(errorDetail) - 1);
+        return error;
+    }
+
+    IoError ActorResult(AxisID axis, IoError error)
+    {
+        if (error != IO_OK)
+            actors[axis]->CopyError(errorDetail, sizeof(errorDetail));
+        return error;
+    }
+
+    // Registers the sample counter, both sensor input words, each axis's
+    // command/actual position and following error and the catcher's filter
+    // output, and takes the scaling the decode needs. Falls back to per-value reads if anything is missing.
+    void PlanStatusBlock()
+    {
+        try
         {
-            cerr << "[Warning] Sensor timeout.\n";
-            return 0.0;
+            bool complete = true;
+            auto add = [this, &complete](uint64_t address, uint32_t bytes) {
+                int field = statusBlock.Add(address, bytes);
+                complete = complete && field >= 0;
+                return field;
+            };
+            sampleField = add(controller->AddressGet(RSIControllerAddressType::RSIControllerAddressTypeSAMPLE_COUNTER), sizeof(uint32_t));
+            for (int s = 0; s < 2; s++)
+            {
+                if (!sensors[s])
+                    return;
+                sensorField[s] = add(sensors[s]->AddressGet(), sizeof(int32_t));
+                sensorMask[s] = sensors[s]->MaskGet();
+            }
+            for (int a = 0; a < AXIS_COUNT; a++)
+            {
+                commandField[a] = add(axes[a]->AddressGet(RSIAxisAddressType::RSIAxisAddressTypeCOMMAND_POSITION), sizeof(double));
+                actualField[a] = add(axes[a]->AddressGet(RSIAxisAddressType::RSIAxisAddressTypeACTUAL_POSITION), sizeof(double));
+                errorField[a] = add(axes[a]->AddressGet(RSIAxisAddressType::RSIAxisAddressTypePOSITION_ERROR), sizeof(double));
+                settleCounts[a] = DemoRig::ToCounts(static_cast<AxisID>(a), axes[a]->PositionToleranceFineGet());
+            }
+            outputField = add(axes[CATCHER]->AddressGet(RSIAxisAddressType::RSIAxisAddressTypeFILTER_OUTPUT), sizeof(double));
+            if (!complete || !statusBlock.Plan())
+            {
+                cerr << "[Status] Rig " << rig << ": status fields do not fit one block, polling values one by one.\n";
+                return;
+            }
+
+            // Raw memory holds counts from the controller's own origin; calibrate
+            // against the SDK's user-unit position while the axes are at rest.
+            for (int s = 0; s < statusBlock.SpanCount(); s++)
+                controller->MemoryBlockGet(statusBlock.SpanAddress(s), statusBlock.SpanData(s), statusBlock.SpanBytes(s));
+            for (int a = 0; a < AXIS_COUNT; a++)
+            {
+                AxisID id = static_cast<AxisID>(a);
+                originOffset[a] = DemoRig::ToUnits(id, statusBlock.Get<double>(actualField[a])) - axes[a]->ActualPositionGet();
+                targetCounts[a] = statusBlock.Get<double>(commandField[a]);
+            }
+            statusPlanned = true;
+            cout << "[Status] Rig " << rig << ": status read as " << statusBlock.SpanCount() << " block(s), "
+                 << statusBlock.TotalBytes() << " bytes per poll.\n";
         }
+        catch (const std::exception &e)
+        {
+            cerr << "[Status] Rig " << rig << ": could not plan block reads (" << e.what() << "), polling values one by one.\n";
+        }
+    }
+
+    // Motion is done once the trajectory has reached the last commanded target
+    // and the following error is inside the fine position tolerance. The
+    // controller aborts an axis the moment its following error passes the
+    // error limit (see InitMotor), so the same comparison here sees the trip;
+    // the error need not stay past the limit afterwards, so the fault is held
+    // until ClearAxisFault.
+    void DecodeStatus(StatusSnapshot &status)
+    {
+        status.sampleCounter = statusBlock.Get<uint32_t>(sampleField);
+        for (int s = 0; s < 2; s++)
+            status.sensors[s] = (statusBlock.Get<int32_t>(sensorField[s]) & sensorMask[s]) != 0;
+        for (int a = 0; a < AXIS_COUNT; a++)
+        {
+            AxisID id = static_cast<AxisID>(a);
+            double command = statusBlock.Get<double>(commandField[a]);
+            double error = statusBlock.Get<double>(errorField[a]);
+            status.actualPosition[a] = DemoRig::ToUnits(id, statusBlock.Get<double>(actualField[a])) - originOffset[a];
+            status.followingError[a] = DemoRig::ToUnits(id, error);
+            status.motionDone[a] = fabs(command - targetCounts[a]) < 1.0 && fabs(error) <= settleCounts[a];
+            if (!tripped[a] && fabs(error) > ERROR_LIMIT_COUNTS[a])
+            {
+                tripped[a] = true;
+                actors[a]->Forget(); // the abort stops the axis short of its target
+            }
+            status.fault[a] = tripped[a];
+            status.filterOutput[a] = 0.0;
+        }
+        status.filterOutput[CATCHER] = statusBlock.Get<double>(outputField);
+    }
+
+    int rig;
+    Axis *const *axes;
+    IOPoint *const *sensors;
+    const unique_ptr<AxisActor> *actors;
+    char errorDetail[160] = "";
+
+    StatusBlock statusBlock;
+    bool statusPlanned = false;
+    int sampleField = -1;
+    int sensorField[2] = {-1, -1};
+    int32_t sensorMask[2] = {};
+    int commandField[AXIS_COUNT] = {};
+    int actualField[AXIS_COUNT] = {};
+    int errorField[AXIS_COUNT] = {};
+    int outputField = -1;
+    double originOffset[AXIS_COUNT] = {};  // user units
+    double targetCounts[AXIS_COUNT] = {};  // last commanded target
+    double settleCounts[AXIS_COUNT] = {};
+    bool tripped[AXIS_COUNT] = {};         // error limit passed, not cleared yet
+
+    // InitMotor sets scaling and error limits from the rig description, so
+    // the decode uses them as compile-time constants.
+    static constexpr double ERROR_LIMIT_COUNTS[AXIS_COUNT] = {
+        DemoRig::ToCounts(RAMP, DemoRig::Axis(RAMP).errorLimit), DemoRig::ToCounts(DOOR, DemoRig::Axis(DOOR).errorLimit),
+        DemoRig::ToCounts(CATCHER, DemoRig::Axis(CATCHER).errorLimit)};
+};
+
+// Operator prompt for a single rig. Entering 1.23 quits and 0 takes the
+// recommended angle; with `automatic` the recommendation launches unasked.
+bool PromptAngle(double &rampAngle, LaunchIO &io, AngleRecommender &recommender, bool automatic)
+{
+    cout << "\n=== New Launch ===" << endl;
+    AngleScore best;
+    bool recommended = recommender.Recommend(io, best);
+    double bestAngle = best.angle + recommender.AngleOffset();
+    if (recommended)
+    {
+        printf("[Recommend] %.1f deg: catch %.1f%%, speed %.3f +/- %.3f m/s, margin %.0f ms / %.3f m\n", bestAngle,
+               best.catchProbability * 100.0, best.speed, best.speedStdDev, best.timingMargin * 1000.0,
+               best.positionMargin);
+    }
+    if (automatic && recommended)
+    {
+        rampAngle = bestAngle;
+        return !gShutdown;
+    }
+    if (automatic)
+        cout << "[Recommend] Not enough history for a recommendation yet." << endl;
 
-        this_thread::sleep_for(chrono::milliseconds(1));
+    cout << "Enter ramp angle (degrees" << (recommended ? ", 0 = recommended" : "") << "): ";
+    if (!(cin >> rampAngle) || rampAngle == 1.23)
+    {
+        gShutdown = true;
+        return false;
     }
+    if (recommended && rampAngle == 0.0)
+        rampAngle = bestAngle;
+
+    // What this angle has done before, from the history store.
+    double commanded = rampAngle - recommender.AngleOffset();
+    const AnglePrior &prior = recommender.Priors().At(commanded);
+    if (prior.count > 0)
+    {
+        printf("[History] %.0f deg: %u launches, speed %.3f +/- %.3f m/s, landing %.3f m\n", commanded, prior.count,
+               prior.meanSpeed, prior.speedStdDev, ComputeLandingPosition(prior.meanSpeed, commanded, recommender.RampHeight()));
+    }
+    return true;
 }
 
-// === PHYSICS ===
-double ComputeSpeed(double t1, double t2)
+// Configured control core for a rig, or one picked away from the RMP core.
+int ControlCpu(int rig)
 {
-    return (t2 > t1) ? SENSOR_DISTANCE / (t2 - t1) : 0.0;
+    const Params &startup = ParamsStartup();
+    return startup.rigs[rig].cpu >= 0 ? startup.rigs[rig].cpu : RtControlCpu(rig, startup.cpuAffinity);
 }
 
-double ComputeLandingPosition(double speed, double angleDeg)
+// One actor per axis from here on, on its rig's control core just above the control thread.
+void StartAxisActors()
 {
-    double angleRad = angleDeg * M_PI / 180.0;
-    double vx = speed * cos(angleRad);
-    double vy = speed * sin(angleRad);
-    double timeUp = vy/GRAVITY;
-    double maxHeight = vy*timeUp + 0.5*GRAVITY*timeUp*timeUp;
-    double timeDown = sqrt((2*(maxHeight+RAMP_HEIGHT))/GRAVITY);
-    double timeOfFlight = timeUp+timeDown;
-    return vx * timeOfFlight;
+    for (int r = 0; r < gRigCount; r++)
+    {
+        int cpu = ControlCpu(r);
+        for (int a = 0; a < AXIS_COUNT; a++)
+        {
+            Axis *axis = gRigs[r].axes[a];
+            auto actor = make_unique<AxisActor>(make_unique<RmpAxisDriver>(axis), axis->AmpEnableGet());
+            char name[16];
+            snprintf(name, sizeof(name), "hw-rig%d-%s", r, AXIS_NAMES[a]);
+            actor->Start(name, cpu, ParamsStartup().rt);
+            gRigs[r].actors[a] = move(actor);
+            gSignalActors[r][a].store(gRigs[r].actors[a].get(), memory_order_release);
+        }
+    }
 }
 
-int main()
+// Runs every configured rig on its own pinned control thread and returns their stats.
+vector<RigStats> RunRigs()
 {
+    const Params &startup = ParamsStartup();
+    vector<RigStats> stats(gRigCount);
+    vector<thread> threads;
+    for (int r = 0; r < gRigCount; r++)
+    {
+        stats[r].rig = r;
+        RigConfig config = startup.rigs[r];
+        config.cpu = ControlCpu(r);
+        RtCheckIsolation(config.cpu);
+        cout << "[Rig " << r << "] axes " << config.axisNumbers[RAMP] << "/" << config.axisNumbers[DOOR] << "/"
+             << config.axisNumbers[CATCHER] << ", CPU " << config.cpu << ", " << config.angles.size() << " angles\n";
+        // Copied: the rig threads outlive any number of reloads into the slot `startup` refers to.
+        RtConfig rt = startup.rt;
+        threads.push_back(StartRigThread(r, config.cpu, [&stats, r, config, rt]() {
+            RtSetupThread(rt);
+            string metricsName = MetricsRigName(r);
+            MetricsOpen(metricsName.c_str(), r);
+            LaunchLogWriter launchLog;
+            string logPath = RigPath(LAUNCH_LOG_PATH, r);
+            if (!launchLog.Open(logPath))
+            {
+                cerr << "[Log] Could not open " << logPath << ", rig " << r << " launches will not be recorded.\n";
+            }
+            RmpLaunchIO io(r);
+            io.verbose = false; // several rigs would interleave on stdout
+            RunRig(io, CycleAngles(config.angles), stats[r], &launchLog, &gHistory);
+            MetricsClose();
+        }));
+    }
+    for (thread &t : threads)
+        t.join();
+    return stats;
+}
+
+int main(int argc, char *argv[])
+{
+    Params startupParams;
+    string paramsError;
+    if (ParamsLoadFile(PARAMS_PATH, startupParams, paramsError))
+    {
+        cout << "[Params] Loaded " << PARAMS_PATH << "\n";
+    }
+    else
+    {
+        cout << "[Params] Using built-in defaults (" << PARAMS_PATH << ": " << paramsError << ")\n";
+    }
+    ParamsInit(startupParams);
+
+    // Sensor edges and every wait read the global clock; use the TSC where it can be trusted.
+    if (SelectTscClock())
+        printf("[Clock] Invariant TSC at %.6f GHz, calibrated against CLOCK_MONOTONIC_RAW\n",
+               static_cast<TscClock &>(GetClock()).TicksPerSecond() * 1e-9);
+    else
+        cout << "[Clock] No invariant TSC, using clock_gettime(CLOCK_MONOTONIC)\n";
+
+    // The simulator, replay and simulated tuning need no controller (hotwheels_sim.cpp).
+    if (argc >= 2 && (string(argv[1]) == "--simulate" || string(argv[1]) == "--replay" || string(argv[1]) == "--bench-rigs"))
+    {
+        cerr << "[HotWheels] " << argv[1] << " runs without the RMP: use hotwheels-sim " << argv[1] << "\n";
+        return 2;
+    }
+    if (argc >= 2 && string(argv[1]) == "--rt-check")
+    {
+        // Wake-up latency under the configured RT settings, without the RMP.
+        int cpu = ControlCpu(0);
+        RtCheckIsolation(cpu);
+        if (cpu >= 0)
+            PinThisThread(cpu);
+        RtSetupProcess(ParamsStartup().rt);
+        RtSetupThread(ParamsStartup().rt);
+        RtMeasureWakeups(argc == 3 ? atof(argv[2]) : 10.0);
+        return 0;
+    }
+    // --tune [ramp|door|catcher|all] [--apply]; hotwheels-sim --tune runs it against the servo model
+    bool tuning = argc >= 2 && string(argv[1]) == "--tune";
+    int tuneAxis = -1;
+    bool tuneApply = false;
+    for (int i = 2; tuning && i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--simulate")
+        {
+            cerr << "[Tune] The simulated sweep runs without the RMP: use hotwheels-sim --tune\n";
+            return 2;
+        }
+        if (arg == "--apply")
+            tuneApply = true;
+        else if (arg != "all")
+        {
+            tuneAxis = static_cast<int>(find(begin(AXIS_NAMES), end(AXIS_NAMES), arg) - begin(AXIS_NAMES));
+            if (tuneAxis == AXIS_COUNT)
+            {
+                cerr << "[Tune] Unknown axis " << arg << " (ramp, door, catcher or all)\n";
+                return 2;
+            }
+        }
+    }
+
+    // --auto-angle: launch the recommended angle every time (single rig)
+    bool autoAngle = argc >= 2 && string(argv[1]) == "--auto-angle";
+
     std::signal(SIGINT, SignalHandler);
     cout << "[HotWheels] Starting demo...\n";
     // motorRamp->AmpEnableSet(false);
@@ -224,68 +714,59 @@ int main()
             return 1;
         }
 
-        while (!gShutdown)
+        // Threads started from here on (the watcher) stay ordinary; control threads go RT.
+        ParamsWatchStart(PARAMS_PATH);
+        RtSetupProcess(ParamsStartup().rt);
+        StartAxisActors();
+        if (!tuning)
         {
-            cout << "\n=== New Launch ===" << endl;
-
-            double rampAngle;
-            cout << "Enter ramp angle (degrees): ";
-            cin >> rampAngle;
-            if (rampAngle == 1.23){
-                gShutdown = true;
-            }
-            // account for angle offset
-            rampAngle = rampAngle - ANGLE_OFFSET;
-
-            // 1. Set ramp angle
-            MoveSCurve(motorRamp, rampAngle);
-            MoveSCurve(motorDoor, 0);
-            //MoveSCurve(motorCatcher, 0);
-
-            // 2. Wait for sensor 1 — car approaching gate
-            double t1 = 0.0, t2 = 0.0;
-            cout << "[Sensor] Waiting for sensor 1..." << endl;
-            while (t1 == 0.0)
-            {
-                t1 = ReadSensor(sensor1Input);
-                if (DEBUG_MODE)
-                {
-                    cout << "[Debug] t1 value: " << t1 << endl;
-                }
-                this_thread::sleep_for(chrono::milliseconds(1));
-            }
-
-            // 3. Open door to let car through
-            cout << "[Gate] Opening door!" << endl;
-            MoveSCurve(motorDoor, 100 - rampAngle);
-
-            // 4. Wait for sensor 2 — car passed
-            cout << "[Sensor] Waiting for sensor 2..." << endl;
-            while (t2 == 0.0)
+            if (gHistory.Open(HISTORY_PATH))
+                cout << "[History] " << gHistory.Rows() << " launches in " << HISTORY_PATH << "\n";
+            else
+                cerr << "[History] Launches will not be added to " << HISTORY_PATH << ".\n";
+        }
+        if (tuning)
+        {
+            // Profile sweep on rig 0's axes; no launches.
+            RtSetupThread(ParamsStartup().rt);
+            RmpLaunchIO io(0);
+            RunProfileTuning(io, tuneAxis, tuneApply ? PARAMS_PATH : nullptr);
+        }
+        else if (gRigCount == 1)
+        {
+            // Single rig: the operator picks every angle on the main thread.
+            int cpu = ControlCpu(0);
+            RtCheckIsolation(cpu);
+            if (cpu >= 0)
+                PinThisThread(cpu);
+            RtSetupThread(ParamsStartup().rt);
+            MetricsOpen();
+            RmpLaunchIO io(0);
+            LaunchLogWriter launchLog;
+            if (!launchLog.Open(LAUNCH_LOG_PATH))
             {
-                t2 = ReadSensor(sensor2Input);
-                if (DEBUG_MODE)
-                {
-                    cout << "[Debug] t2 value: " << t2 << endl;
-                }
-                this_thread::sleep_for(chrono::milliseconds(1));
+                cerr << "[Log] Could not open " << LAUNCH_LOG_PATH << ", launches will not be recorded.\n";
             }
-
-            // 5. Close door again
-            cout << "[Gate] Closing door." << endl;
-            MoveSCurve(motorDoor, 0.0);
-
-            // 6. Compute physics
-            double speed = ComputeSpeed(t1, t2);
-            double landing = ComputeLandingPosition(speed, rampAngle);
-            landing = std::clamp(landing, MIN_CATCHER_POSITION, MAX_CATCHER_POSITION);
-
-            cout << "[Physics] Speed: " << speed << " m/s | Landing: " << landing << " m" << endl;
-
-            // 7. Move catcher
-            MoveSCurve(motorCatcher, landing);
-
-            this_thread::sleep_for(chrono::seconds(3));
+            AngleRecommender recommender;
+            auto nextAngle = [&](double &angle) { return PromptAngle(angle, io, recommender, autoAngle); };
+            auto rigStats = make_unique<RigStats>(); // ~200 KiB of sketches, keep it off the prefaulted stack
+            RigStats &stats = *rigStats;
+            RunRig(io, nextAngle, stats, &launchLog, &gHistory, &recommender);
+            MetricsClose();
+            PrintRigJitter(stats);
+            PrintTrackerStats(stats.rig, stats.tracking);
+            PrintCorrectionStats(stats.rig, stats.correction);
+            PrintOcclusionStats(stats.rig, stats.occlusion);
+            PrintRecoveryStats(stats.rig, stats.recovery);
+            stats.statistics.Print();
+        }
+        else
+        {
+            cout << "[HotWheels] Running " << gRigCount << " rigs on their configured angle lists (Ctrl+C to stop).\n";
+            vector<RigStats> stats = RunRigs();
+            PrintRigStats(stats);
+            for (const RigStats &rig : stats)
+                PrintRigJitter(rig);
         }
     }
     catch (const std::exception &ex)
@@ -295,13 +776,34 @@ int main()
 
     // --- Shutdown Cleanup ---
     cout << "[Shutdown] Cleaning up...\n";
+    AxisTraceStop();
+    ParamsWatchStop();
+    MetricsClose();
+    SpanTraceExport(SPAN_TRACE_PATH);
     if (controller)
     {
         try
         {
-            motorRamp->AmpEnableSet(false);
-            motorDoor->AmpEnableSet(false);
-            motorCatcher->AmpEnableSet(false);
+            for (int r = 0; r < gRigCount; r++)
+            {
+                for (int a = 0; a < AXIS_COUNT; a++)
+                {
+                    AxisActor *actor = gRigs[r].actors[a].get();
+                    if (!actor)
+                    {
+                        // Setup stopped before the actors started; nothing else drives the axis.
+                        if (gRigs[r].axes[a])
+                            gRigs[r].axes[a]->AmpEnableSet(false);
+                        continue;
+                    }
+                    // Already off if a signal got here first.
+                    if (actor->SetAmp(false) != IO_OK)
+                        cerr << "[Cleanup] Rig " << r << " " << AXIS_NAMES[a] << ": amp disable not confirmed.\n";
+                    gSignalActors[r][a].store(nullptr, memory_order_release);
+                    actor->Stop();
+                    PrintAxisActorStats(r, AXIS_NAMES[a], actor->Stats());
+                }
+            }
             controller->Delete();
         }
         catch (...)
@@ -312,4 +814,4 @@ int main()
 
     cout << "[HotWheels] Demo finished.\n";
     return 0;
-}
\ No newline at end of file
+}
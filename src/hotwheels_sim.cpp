@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include "alloc_guard.h"
+#include "clock.h"
+#include "metrics.h"
+#include "params.h"
+#include "replay.h"
+#include "sim_rig.h"
+#include "span_trace.h"
+
+using namespace std;
+
+// hotwheels-sim: the simulated rig, offline replay and simulated tuning; no RSI SDK needed.
+//   hotwheels-sim --simulate <launches> [--realtime] [--auto-angle] [--faults <rate>] [--pipeline]
+//   hotwheels-sim --replay <launches.csv>
+//   hotwheels-sim --tune [ramp|door|catcher|all] [--apply]
+//   hotwheels-sim --bench-rigs <max rigs> <launches per rig>
+
+constexpr const char *PARAMS_PATH = "hotwheels_params.conf";
+constexpr const char *SPAN_TRACE_PATH = "hotwheels_spans.json"; // only written with HOTWHEELS_TRACE_SPANS
+
+namespace
+{
+    void PrintUsage(const char *program)
+    {
+        fprintf(stderr,
+                "usage: %s --simulate <launches> [--realtime] [--auto-angle] [--faults <rate>] [--pipeline]\n"
+                "       %s --replay <launches.csv>\n"
+                "       %s --tune [ramp|door|catcher|all] [--apply]\n"
+                "       %s --bench-rigs <max rigs> <launches per rig>\n",
+                program, program, program, program);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    Params startupParams;
+    string paramsError;
+    if (ParamsLoadFile(PARAMS_PATH, startupParams, paramsError))
+    {
+        cout << "[Params] Loaded " << PARAMS_PATH << "\n";
+    }
+    else
+    {
+        cout << "[Params] Using built-in defaults (" << PARAMS_PATH << ": " << paramsError << ")\n";
+    }
+    ParamsInit(startupParams);
+
+    // Real-time runs and the wall-clock figures read the global clock; use the TSC where it can be trusted.
+    if (SelectTscClock())
+        printf("[Clock] Invariant TSC at %.6f GHz, calibrated against CLOCK_MONOTONIC_RAW\n",
+               static_cast<TscClock &>(GetClock()).TicksPerSecond() * 1e-9);
+    else
+        cout << "[Clock] No invariant TSC, using clock_gettime(CLOCK_MONOTONIC)\n";
+
+    string mode = argv[1];
+    if (mode == "--replay" && argc == 3)
+    {
+        return RunReplay(argv[2]);
+    }
+    if (mode == "--simulate" && argc >= 3)
+    {
+        bool realtime = false, autoAngle = false;
+        double faultRate = 0.0;
+        for (int i = 3; i < argc; i++)
+        {
+            realtime |= string(argv[i]) == "--realtime";
+            autoAngle |= string(argv[i]) == "--auto-angle";
+            if (string(argv[i]) == "--faults" && i + 1 < argc)
+                faultRate = atof(argv[++i]);
+            if (string(argv[i]) == "--pipeline")
+            {
+                startupParams.launch.pipelineCars = true; // same as pipeline_cars = 1
+                ParamsInit(startupParams);
+            }
+        }
+        MetricsOpen();
+        int result = RunSimulation(atoi(argv[2]), !realtime, autoAngle, faultRate);
+        MetricsClose();
+        AllocGuardReport();
+        SpanTraceExport(SPAN_TRACE_PATH);
+        return result;
+    }
+    if (mode == "--tune")
+    {
+        int tuneAxis = -1;
+        bool tuneApply = false;
+        for (int i = 2; i < argc; i++)
+        {
+            string arg = argv[i];
+            if (arg == "--apply")
+                tuneApply = true;
+            else if (arg != "all" && arg != "--simulate")
+            {
+                tuneAxis = static_cast<int>(find(begin(AXIS_NAMES), end(AXIS_NAMES), arg) - begin(AXIS_NAMES));
+                if (tuneAxis == AXIS_COUNT)
+                {
+                    cerr << "[Tune] Unknown axis " << arg << " (ramp, door, catcher or all)\n";
+                    return 2;
+                }
+            }
+        }
+        return RunTuningSimulation(tuneAxis, tuneApply ? PARAMS_PATH : nullptr);
+    }
+    if (mode == "--bench-rigs" && argc == 4)
+    {
+        int result = RunRigBenchmark(atoi(argv[2]), atoi(argv[3]));
+        SpanTraceExport(SPAN_TRACE_PATH);
+        return result;
+    }
+    PrintUsage(argv[0]);
+    return 2;
+}
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include "metrics.h"
+#include "stream_stats.h"
+
+using namespace std;
+
+// hotwheels-stat: prints the live metrics page published by HotWheelsDemo.
+//   hotwheels-stat            print once
+//   hotwheels-stat -w <ms>    stream every <ms> milliseconds
+//   hotwheels-stat -r <rig>   read another rig's page (multi-rig runs)
+
+volatile sig_atomic_t gStop = 0;
+
+void PrintPage(const MetricsPage &page)
+{
+    printf("pid %d | rig %d | launches %llu | catches %llu | misses %llu | undetected %llu | sensor timeouts %llu\n",
+           page.pid, page.rig, (unsigned long long)page.launches, (unsigned long long)page.catches,
+           (unsigned long long)page.misses, (unsigned long long)page.undetected, (unsigned long long)page.sensorTimeouts);
+    printf("targets  ramp %.3f deg | door %.3f deg | catcher %.4f m\n",
+           page.axisTarget[RAMP], page.axisTarget[DOOR], page.axisTarget[CATCHER]);
+    printf("last     angle %.2f deg | speed %.4f m/s | landing %.4f m | margin %.1f ms\n",
+           page.lastAngle, page.lastSpeed, page.lastLanding, page.lastMargin * 1000.0);
+    printf("%-14s %10s %12s %12s %12s\n", "phase", "count", "last_us", "mean_us", "max_us");
+    for (int i = 0; i < PHASE_COUNT; i++)
+    {
+        const PhaseStats &stats = page.phases[i];
+        double mean = stats.count ? static_cast<double>(stats.totalNs) / stats.count : 0.0;
+        printf("%-14s %10llu %12.1f %12.1f %12.1f\n", LAUNCH_PHASE_NAMES[i], (unsigned long long)stats.count,
+               stats.lastNs / 1000.0, mean / 1000.0, stats.maxNs / 1000.0);
+    }
+    JitterPrint(page.loopWakeup, page.loopExec);
+
+    if (page.statsBytes == 0)
+        return;
+    auto statistics = make_unique<LaunchStatistics>();
+    if (statistics->Deserialize(page.stats, page.statsBytes))
+        statistics->Print();
+    else
+        fprintf(stderr, "[Stat] Launch statistics blob is corrupt or from another version.\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int intervalMs = 0;
+    int rig = 0;
+    for (int i = 1; i < argc; i += 2)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "-w") == 0)
+            intervalMs = atoi(argv[i + 1]);
+        else if (i + 1 < argc && strcmp(argv[i], "-r") == 0)
+            rig = atoi(argv[i + 1]);
+        else
+        {
+            fprintf(stderr, "usage: %s [-w <interval ms>] [-r <rig>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    string name = MetricsRigName(rig);
+    const MetricsPage *page = MetricsMapReadOnly(name.c_str());
+    if (!page)
+    {
+        fprintf(stderr, "[Stat] No metrics page at /dev/shm%s (is HotWheelsDemo running?)\n", name.c_str());
+        return 1;
+    }
+
+    signal(SIGINT, [](int) { gStop = 1; });
+    do
+    {
+        MetricsPage snapshot;
+        if (!MetricsSnapshot(page, snapshot))
+        {
+            fprintf(stderr, "[Stat] Page kept changing, could not take a snapshot.\n");
+            return 1;
+        }
+        PrintPage(snapshot);
+        if (intervalMs > 0)
+        {
+            printf("\n");
+            fflush(stdout);
+            this_thread::sleep_for(chrono::milliseconds(intervalMs));
+        }
+    } while (intervalMs > 0 && !gStop);
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "jitter_monitor.h"
+#include "launch_model.h"
+#include "metrics.h"
+#include <cstdio>
+
+using namespace std;
+
+namespace
+{
+    // Zero-initialised per thread; nothing here is ever allocated.
+    thread_local JitterHistogram tWakeups;
+    thread_local JitterHistogram tExec;
+    thread_local int64_t tWakeupBudgetNs = static_cast<int64_t>(WAKEUP_BUDGET_US * 1000.0);
+    thread_local int64_t tExecBudgetNs = static_cast<int64_t>(EXEC_BUDGET_US * 1000.0);
+    thread_local JitterOverruns tOverruns;
+}
+
+void JitterSetBudget(int64_t wakeupNs, int64_t execNs)
+{
+    tWakeupBudgetNs = wakeupNs;
+    tExecBudgetNs = execNs;
+}
+
+void JitterRecord(int64_t wakeupNs, int64_t execNs)
+{
+    bool lateWakeup = wakeupNs > tWakeupBudgetNs;
+    bool longExec = execNs > tExecBudgetNs;
+    JitterAdd(tWakeups, wakeupNs, lateWakeup);
+    JitterAdd(tExec, execNs, longExec);
+    if (lateWakeup || longExec)
+    {
+        tOverruns.count++;
+        if (wakeupNs > tOverruns.worstWakeupNs)
+            tOverruns.worstWakeupNs = wakeupNs;
+        if (execNs > tOverruns.worstExecNs)
+            tOverruns.worstExecNs = execNs;
+    }
+    MetricsLoopIteration(wakeupNs, execNs, lateWakeup, longExec);
+}
+
+JitterOverruns JitterTakeOverruns()
+{
+    JitterOverruns overruns = tOverruns;
+    tOverruns = {};
+    return overruns;
+}
+
+const JitterHistogram &JitterWakeups()
+{
+    return tWakeups;
+}
+
+const JitterHistogram &JitterExec()
+{
+    return tExec;
+}
+
+void JitterPrint(const JitterHistogram &wakeups, const JitterHistogram &exec)
+{
+    printf("%-16s %14s %14s\n", "loop (us)", "wakeup", "exec");
+    for (int b = 0; b < JITTER_BUCKETS; b++)
+    {
+        if (!wakeups.buckets[b] && !exec.buckets[b])
+            continue;
+        char label[32];
+        if (b == JITTER_BUCKETS - 1)
+            snprintf(label, sizeof(label), ">= %.0f", JitterBucketLowerNs(b) / 1000.0);
+        else
+            snprintf(label, sizeof(label), "%.0f - %.0f", JitterBucketLowerNs(b) / 1000.0, JitterBucketLowerNs(b + 1) / 1000.0);
+        printf("%-16s %14llu %14llu\n", label, (unsigned long long)wakeups.buckets[b], (unsigned long long)exec.buckets[b]);
+    }
+    auto mean = [](const JitterHistogram &h) { return h.count ? h.totalNs / 1000.0 / h.count : 0.0; };
+    printf("%-16s %14llu %14llu\n", "count", (unsigned long long)wakeups.count, (unsigned long long)exec.count);
+    printf("%-16s %14.1f %14.1f\n", "mean", mean(wakeups), mean(exec));
+    printf("%-16s %14.1f %14.1f\n", "max", wakeups.maxNs / 1000.0, exec.maxNs / 1000.0);
+    printf("%-16s %14llu %14llu\n", "over budget", (unsigned long long)wakeups.overBudget, (unsigned long long)exec.overBudget);
+}
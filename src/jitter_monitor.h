@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+
+// === JITTER MONITOR ===
+// Always-on timing of every control-loop iteration (each sensor/motion poll):
+// how late the thread woke up against its deadline and how long it then ran
+// before sleeping again. Samples go into fixed log2 histograms held per thread
+// and mirrored on that thread's metrics page; recording is a few adds with no
+// allocation and no locks. Iterations over budget are counted and reported by
+// the launch once its catcher command is out.
+
+constexpr int JITTER_BUCKETS = 24; // log2 buckets, see JitterBucketLowerNs()
+
+struct JitterHistogram
+{
+    uint64_t buckets[JITTER_BUCKETS];
+    uint64_t count;
+    uint64_t overBudget;
+    int64_t maxNs;
+    int64_t totalNs;
+};
+
+// Bucket 0 holds [0, 1024) ns, bucket b holds [2^(b+9), 2^(b+10)) ns and the
+// last bucket everything from ~4.3 s up.
+inline int JitterBucket(int64_t ns)
+{
+    if (ns < 1024)
+        return 0;
+    int bucket = 63 - __builtin_clzll(static_cast<uint64_t>(ns)) - 9;
+    return bucket < JITTER_BUCKETS ? bucket : JITTER_BUCKETS - 1;
+}
+
+inline int64_t JitterBucketLowerNs(int bucket) { return bucket == 0 ? 0 : int64_t(1) << (bucket + 9); }
+
+inline void JitterAdd(JitterHistogram &histogram, int64_t ns, bool overBudget)
+{
+    if (ns < 0)
+        ns = 0;
+    histogram.buckets[JitterBucket(ns)]++;
+    histogram.count++;
+    histogram.totalNs += ns;
+    if (ns > histogram.maxNs)
+        histogram.maxNs = ns;
+    if (overBudget)
+        histogram.overBudget++;
+}
+
+// Control-thread side (thread-local state).
+void JitterSetBudget(int64_t wakeupNs, int64_t execNs);
+void JitterRecord(int64_t wakeupNs, int64_t execNs);
+
+struct JitterOverruns
+{
+    uint64_t count;
+    int64_t worstWakeupNs;
+    int64_t worstExecNs;
+};
+JitterOverruns JitterTakeOverruns(); // since the previous call on this thread
+
+const JitterHistogram &JitterWakeups();
+const JitterHistogram &JitterExec();
+
+// cyclictest-style table: one row per non-empty bucket plus count/mean/max.
+void JitterPrint(const JitterHistogram &wakeups, const JitterHistogram &exec);
@@ -0,0 +1,113 @@
+#include "landing_correction.h"
+#include "launch_pipeline.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+using namespace std;
+
+namespace
+{
+    void Features(double speed, double angleDeg, double phi[CORRECTION_FEATURES])
+    {
+        phi[0] = 1.0;
+        phi[1] = speed;
+        phi[2] = angleDeg * M_PI / 180.0;
+    }
+
+    double Dot(const double *a, const double *b)
+    {
+        double sum = 0.0;
+        for (int i = 0; i < CORRECTION_FEATURES; i++)
+            sum += a[i] * b[i];
+        return sum;
+    }
+}
+
+LandingCorrection::LandingCorrection()
+{
+    for (int i = 0; i < CORRECTION_FEATURES; i++)
+        covariance[i][i] = CORRECTION_INITIAL_COVARIANCE;
+}
+
+double LandingCorrection::Apply(double speed, double angleDeg) const
+{
+    double phi[CORRECTION_FEATURES];
+    Features(speed, angleDeg, phi);
+    double coefficients[CORRECTION_FEATURES];
+    uint32_t before, after;
+    do
+    {
+        before = sequence.load(memory_order_acquire);
+        for (int i = 0; i < CORRECTION_FEATURES; i++)
+            coefficients[i] = published[i].load(memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        after = sequence.load(memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    return clamp(Dot(coefficients, phi), -CORRECTION_MAX, CORRECTION_MAX);
+}
+
+void LandingCorrection::Update(const LaunchRecord &record)
+{
+    if (record.outcome != CATCH_CAUGHT || record.speed <= 0.0)
+        return;
+    double phi[CORRECTION_FEATURES];
+    Features(record.speed, record.angle, phi);
+    double residual = record.impactPosition - record.modelLanding;
+    if (fabs(residual) > CORRECTION_MAX_RESIDUAL)
+    {
+        stats.rejected++;
+        return;
+    }
+    double corrected = residual - record.landingCorrection;
+    stats.modelErrorSq += residual * residual;
+    stats.correctedErrorSq += corrected * corrected;
+
+    // k = P phi / (lambda + phi' P phi); theta += k (y - theta' phi); P = (P - k phi' P) / lambda
+    double pPhi[CORRECTION_FEATURES];
+    for (int i = 0; i < CORRECTION_FEATURES; i++)
+        pPhi[i] = Dot(covariance[i], phi);
+    double gain = 1.0 / (CORRECTION_FORGETTING + Dot(phi, pPhi));
+    double error = residual - Dot(theta, phi);
+    for (int i = 0; i < CORRECTION_FEATURES; i++)
+        theta[i] += gain * pPhi[i] * error;
+
+    // Forgetting only while the covariance is no larger than it started, so
+    // launches that all look alike (one angle, steady speed) cannot wind it up.
+    double trace = 0.0;
+    for (int i = 0; i < CORRECTION_FEATURES; i++)
+        trace += covariance[i][i];
+    double forget = trace < CORRECTION_FEATURES * CORRECTION_INITIAL_COVARIANCE ? CORRECTION_FORGETTING : 1.0;
+    for (int i = 0; i < CORRECTION_FEATURES; i++)
+    {
+        for (int j = 0; j < CORRECTION_FEATURES; j++)
+            covariance[i][j] = (covariance[i][j] - gain * pPhi[i] * pPhi[j]) / forget;
+    }
+
+    stats.updates++;
+    if (stats.updates >= static_cast<uint64_t>(CORRECTION_MIN_UPDATES))
+        Publish();
+}
+
+void LandingCorrection::Publish()
+{
+    for (int i = 0; i < CORRECTION_FEATURES; i++)
+        stats.coefficients[i] = theta[i];
+    uint32_t seq = sequence.load(memory_order_relaxed);
+    sequence.store(seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    for (int i = 0; i < CORRECTION_FEATURES; i++)
+        published[i].store(theta[i], memory_order_relaxed);
+    sequence.store(seq + 2, memory_order_release);
+}
+
+void PrintCorrectionStats(int rig, const CorrectionStats &stats)
+{
+    if (stats.updates == 0)
+        return;
+    printf("[Rig %d] Landing correction: %llu caught launches fitted, %llu rejected | model error rms %.1f mm, "
+           "corrected %.1f mm | %+.4f %+.4f*v %+.4f*angle m\n",
+           rig, (unsigned long long)stats.updates, (unsigned long long)stats.rejected,
+           sqrt(stats.modelErrorSq / stats.updates) * 1000.0, sqrt(stats.correctedErrorSq / stats.updates) * 1000.0,
+           stats.coefficients[0], stats.coefficients[1], stats.coefficients[2]);
+}
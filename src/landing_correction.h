@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+struct LaunchRecord;
+
+// === LANDING CORRECTION ===
+// Learns what ComputeLandingPosition() gets wrong on this rig (friction,
+// drag, a ramp height that is a little off) from where the cars actually
+// land. The correction is linear in the measured speed and ramp angle,
+//     correction = c0 + c1 * speed + c2 * angle (rad),
+// fitted by recursive least squares with exponential forgetting to the
+// difference between each caught car's estimated impact point and the
+// uncorrected model (see catch_detector.h).
+//
+// Update() runs between launches on a single writer thread and publishes the
+// coefficients under a sequence lock; Apply() runs in RunLaunch() on the hot
+// path in constant time, never blocks and never allocates. Nothing is applied
+// until CORRECTION_MIN_UPDATES cars have been fitted, and the applied
+// correction is clamped to +/- CORRECTION_MAX.
+
+constexpr int CORRECTION_FEATURES = 3;          // 1, speed, angle
+constexpr double CORRECTION_FORGETTING = 0.98;  // per update; older launches fade with a ~50 launch memory
+constexpr double CORRECTION_INITIAL_COVARIANCE = 1.0; // per coefficient, m^2 per feature unit^2
+constexpr int CORRECTION_MIN_UPDATES = 5;
+constexpr double CORRECTION_MAX = 0.1;          // m, applied correction limit
+constexpr double CORRECTION_MAX_RESIDUAL = 0.2; // m, larger residuals are not a model error; ignored
+
+struct CorrectionStats
+{
+    double coefficients[CORRECTION_FEATURES] = {};
+    uint64_t updates = 0;
+    uint64_t rejected = 0;      // residual over CORRECTION_MAX_RESIDUAL
+    double modelErrorSq = 0.0;  // m^2 summed: impact minus uncorrected model
+    double correctedErrorSq = 0.0; // m^2 summed: impact minus the correction in force at the launch
+};
+
+class LandingCorrection
+{
+public:
+    LandingCorrection();
+
+    // m to add to the model's landing for a car at `speed` (m/s) off a ramp at `angleDeg`.
+    double Apply(double speed, double angleDeg) const;
+
+    // Fits a completed launch's outcome; launches that were not caught teach nothing.
+    void Update(const LaunchRecord &record);
+
+    const CorrectionStats &Stats() const { return stats; } // writer thread only
+
+private:
+    void Publish();
+
+    // Writer side.
+    double theta[CORRECTION_FEATURES] = {};
+    double covariance[CORRECTION_FEATURES][CORRECTION_FEATURES] = {};
+    CorrectionStats stats;
+
+    // Published coefficients, all zero until warmed up.
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<double> published[CORRECTION_FEATURES] = {};
+};
+
+void PrintCorrectionStats(int rig, const CorrectionStats &stats);
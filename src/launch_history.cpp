@@ -0,0 +1,408 @@
+#include "launch_history.h"
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+const HistoryColumnInfo HISTORY_COLUMN_INFO[HISTORY_COLUMNS] = {
+    {"wall_time", 8},      {"angle", 8},          {"t1", 8},          {"t2", 8},
+    {"speed", 8},          {"landing", 8},        {"time_of_flight", 8}, {"margin", 8},
+    {"door_open_cmd", 8},  {"door_close_cmd", 8}, {"catcher_cmd", 8}, {"catcher_settle", 8},
+    {"landing_error", 8},  {"outcome", 1},        {"rig", 1},
+};
+
+int HistoryColumnByName(const string &name)
+{
+    for (int c = 0; c < HISTORY_COLUMNS; c++)
+    {
+        if (name == HISTORY_COLUMN_INFO[c].name)
+            return c;
+    }
+    return -1;
+}
+
+namespace
+{
+    string ColumnPath(const string &directory, int column)
+    {
+        return directory + "/" + HISTORY_COLUMN_INFO[column].name + ".col";
+    }
+
+    string IndexPath(const string &directory)
+    {
+        return directory + "/index.bin";
+    }
+
+    uint64_t BlocksFor(uint64_t rows)
+    {
+        return (rows + HISTORY_BLOCK_ROWS - 1) / HISTORY_BLOCK_ROWS;
+    }
+
+    void Widen(HistoryBlock &block, double angle, double time, bool first)
+    {
+        if (first)
+        {
+            block = {angle, angle, time, time};
+            return;
+        }
+        block.minAngle = min(block.minAngle, angle);
+        block.maxAngle = max(block.maxAngle, angle);
+        block.minTime = min(block.minTime, time);
+        block.maxTime = max(block.maxTime, time);
+    }
+
+    // Nearest-rank percentiles need a partial sort, so `values` is reordered.
+    HistoryAggregate Summarize(vector<double> &values)
+    {
+        HistoryAggregate result;
+        result.count = values.size();
+        if (values.empty())
+            return result;
+
+        double sum = 0.0;
+        result.min = values[0];
+        result.max = values[0];
+        for (double v : values)
+        {
+            sum += v;
+            result.min = min(result.min, v);
+            result.max = max(result.max, v);
+        }
+        result.mean = sum / values.size();
+        double squares = 0.0;
+        for (double v : values)
+            squares += (v - result.mean) * (v - result.mean);
+        result.stddev = values.size() > 1 ? sqrt(squares / (values.size() - 1)) : 0.0;
+
+        // Each rank is at or above the previous one, so every nth_element only
+        // needs to look at what lies past the last. It may move that element
+        // again, so each percentile is read before the next partition.
+        auto rank = [&](double q) { return values.begin() + static_cast<size_t>(llround(q * (values.size() - 1))); };
+        auto p50 = rank(0.50), p95 = rank(0.95), p99 = rank(0.99);
+        nth_element(values.begin(), p50, values.end());
+        result.p50 = *p50;
+        nth_element(p50, p95, values.end());
+        result.p95 = *p95;
+        nth_element(p95, p99, values.end());
+        result.p99 = *p99;
+        return result;
+    }
+
+    vector<double> Collect(const HistoryReader &reader, HistoryColumn column, const HistoryQuery &query)
+    {
+        vector<double> values;
+        values.reserve(query.last ? min(query.last, reader.Rows()) : reader.Rows());
+        if (HISTORY_COLUMN_INFO[column].width == 8)
+        {
+            const double *data = reader.Doubles(column);
+            HistoryScan(reader, query, [&](uint64_t row) {
+                if (!isnan(data[row]))
+                    values.push_back(data[row]);
+            });
+        }
+        else
+        {
+            const uint8_t *data = reader.Bytes(column);
+            HistoryScan(reader, query, [&](uint64_t row) { values.push_back(data[row]); });
+        }
+        return values;
+    }
+}
+
+// === WRITER ===
+bool HistoryWriter::Open(const string &directory)
+{
+    Close();
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        cerr << "[History] Could not create " << directory << ": " << strerror(errno) << "\n";
+        return false;
+    }
+
+    // Rows are complete only up to the shortest column; trim anything past it.
+    rows = UINT64_MAX;
+    for (int c = 0; c < HISTORY_COLUMNS; c++)
+    {
+        string path = ColumnPath(directory, c);
+        columnFds[c] = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        struct stat info;
+        if (columnFds[c] < 0 || fstat(columnFds[c], &info) != 0)
+        {
+            cerr << "[History] Could not open " << path << ": " << strerror(errno) << "\n";
+            Close();
+            return false;
+        }
+        rows = min<uint64_t>(rows, info.st_size / HISTORY_COLUMN_INFO[c].width);
+    }
+    for (int c = 0; c < HISTORY_COLUMNS; c++)
+    {
+        if (ftruncate(columnFds[c], rows * HISTORY_COLUMN_INFO[c].width) != 0)
+        {
+            cerr << "[History] Could not trim " << ColumnPath(directory, c) << ": " << strerror(errno) << "\n";
+            Close();
+            return false;
+        }
+    }
+
+    string indexPath = IndexPath(directory);
+    indexFd = open(indexPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    struct stat info;
+    if (indexFd < 0 || fstat(indexFd, &info) != 0)
+    {
+        cerr << "[History] Could not open " << indexPath << ": " << strerror(errno) << "\n";
+        Close();
+        return false;
+    }
+    if (static_cast<uint64_t>(info.st_size) != BlocksFor(rows) * sizeof(HistoryBlock) && !RebuildIndex())
+    {
+        cerr << "[History] Could not rebuild " << indexPath << "\n";
+        Close();
+        return false;
+    }
+    if (rows % HISTORY_BLOCK_ROWS != 0 &&
+        pread(indexFd, &block, sizeof(block), (rows / HISTORY_BLOCK_ROWS) * sizeof(HistoryBlock)) != sizeof(block))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool HistoryWriter::RebuildIndex()
+{
+    if (ftruncate(indexFd, 0) != 0)
+        return false;
+    vector<double> angles(HISTORY_BLOCK_ROWS), times(HISTORY_BLOCK_ROWS);
+    for (uint64_t start = 0; start < rows; start += HISTORY_BLOCK_ROWS)
+    {
+        uint64_t count = min<uint64_t>(HISTORY_BLOCK_ROWS, rows - start);
+        size_t bytes = count * sizeof(double);
+        if (pread(columnFds[COL_ANGLE], angles.data(), bytes, start * sizeof(double)) != static_cast<ssize_t>(bytes) ||
+            pread(columnFds[COL_WALL_TIME], times.data(), bytes, start * sizeof(double)) != static_cast<ssize_t>(bytes))
+            return false;
+        HistoryBlock rebuilt{};
+        for (uint64_t i = 0; i < count; i++)
+            Widen(rebuilt, angles[i], times[i], i == 0);
+        off_t offset = (start / HISTORY_BLOCK_ROWS) * sizeof(HistoryBlock);
+        if (pwrite(indexFd, &rebuilt, sizeof(rebuilt), offset) != sizeof(rebuilt))
+            return false;
+    }
+    return true;
+}
+
+void HistoryWriter::Append(const LaunchRecord &record, int rig)
+{
+    lock_guard<mutex> lock(appendMutex);
+    if (indexFd < 0)
+        return;
+
+    // Only a detected impact says where the car came down; NaN rows drop out of every aggregate.
+    double landingError = record.outcome == CATCH_CAUGHT ? record.impactPosition - record.landing : NAN;
+    double values[HISTORY_COLUMNS] = {
+        record.wallTime,        record.angle,         record.t1,           record.t2,
+        record.speed,           record.landing,       record.timeOfFlight, record.margin,
+        record.doorOpenCmd,     record.doorCloseCmd,  record.catcherCmd,   record.catcherSettle,
+        landingError,           0.0,                  0.0,
+    };
+    uint8_t outcome = (record.feasible ? OUTCOME_FEASIBLE : 0) | (record.ioErrorCount ? OUTCOME_IO_ERROR : 0) |
+                      (record.outcome == CATCH_CAUGHT ? OUTCOME_CAUGHT : 0) |
+                      (record.outcome == CATCH_MISSED ? OUTCOME_MISSED : 0);
+    uint8_t rigByte = static_cast<uint8_t>(rig);
+
+    // The index entry goes first: a block may then briefly cover a row that is
+    // not there yet, which only costs a reader a scan, never a missed row.
+    Widen(block, record.angle, record.wallTime, rows % HISTORY_BLOCK_ROWS == 0);
+    bool ok = pwrite(indexFd, &block, sizeof(block), (rows / HISTORY_BLOCK_ROWS) * sizeof(HistoryBlock)) == sizeof(block);
+    for (int c = 0; c < HISTORY_COLUMNS && ok; c++)
+    {
+        const void *data = (c == COL_OUTCOME) ? static_cast<const void *>(&outcome)
+                         : (c == COL_RIG)     ? static_cast<const void *>(&rigByte)
+                                              : static_cast<const void *>(&values[c]);
+        ok = write(columnFds[c], data, HISTORY_COLUMN_INFO[c].width) == HISTORY_COLUMN_INFO[c].width;
+    }
+    if (!ok)
+    {
+        cerr << "[History] Write failed (" << strerror(errno) << "), no further launches will be recorded.\n";
+        Close();
+        return;
+    }
+    rows++;
+}
+
+void HistoryWriter::Close()
+{
+    for (int &fd : columnFds)
+    {
+        if (fd >= 0)
+            close(fd);
+        fd = -1;
+    }
+    if (indexFd >= 0)
+        close(indexFd);
+    indexFd = -1;
+}
+
+// === READER ===
+bool HistoryReader::Open(const string &directory)
+{
+    Close();
+    rows = UINT64_MAX;
+    for (int c = 0; c < HISTORY_COLUMNS; c++)
+    {
+        int fd = open(ColumnPath(directory, c).c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0)
+        {
+            if (fd >= 0)
+                close(fd);
+            Close();
+            return false;
+        }
+        rows = min<uint64_t>(rows, info.st_size / HISTORY_COLUMN_INFO[c].width);
+        mapBytes[c] = info.st_size;
+        if (mapBytes[c] > 0)
+        {
+            void *map = mmap(nullptr, mapBytes[c], PROT_READ, MAP_SHARED, fd, 0);
+            maps[c] = (map == MAP_FAILED) ? nullptr : map;
+        }
+        close(fd);
+        if (mapBytes[c] > 0 && !maps[c])
+        {
+            Close();
+            return false;
+        }
+        if (maps[c])
+            madvise(const_cast<void *>(maps[c]), mapBytes[c], MADV_SEQUENTIAL);
+    }
+
+    // A missing or short index only means fewer blocks can be skipped.
+    int fd = open(IndexPath(directory).c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd >= 0 && fstat(fd, &info) == 0)
+    {
+        blocks.resize(min<uint64_t>(info.st_size / sizeof(HistoryBlock), BlocksFor(rows)));
+        size_t bytes = blocks.size() * sizeof(HistoryBlock);
+        if (pread(fd, blocks.data(), bytes, 0) != static_cast<ssize_t>(bytes))
+            blocks.clear();
+    }
+    if (fd >= 0)
+        close(fd);
+    return true;
+}
+
+void HistoryReader::Close()
+{
+    for (int c = 0; c < HISTORY_COLUMNS; c++)
+    {
+        if (maps[c])
+            munmap(const_cast<void *>(maps[c]), mapBytes[c]);
+        maps[c] = nullptr;
+        mapBytes[c] = 0;
+    }
+    rows = 0;
+    blocks.clear();
+}
+
+double HistoryReader::Value(HistoryColumn column, uint64_t row) const
+{
+    return HISTORY_COLUMN_INFO[column].width == 8 ? Doubles(column)[row] : Bytes(column)[row];
+}
+
+// === QUERIES ===
+HistoryAggregate HistoryAggregateColumn(const HistoryReader &reader, HistoryColumn column, const HistoryQuery &query)
+{
+    vector<double> values = Collect(reader, column, query);
+    return Summarize(values);
+}
+
+vector<HistoryAggregate> HistoryTrend(const HistoryReader &reader, HistoryColumn column, const HistoryQuery &query,
+                                      int buckets, double &slope)
+{
+    vector<double> values = Collect(reader, column, query);
+
+    // Least squares against the launch index, before Summarize reorders anything.
+    double n = values.size(), sumX = 0.0, sumY = 0.0, sumXY = 0.0, sumXX = 0.0;
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        sumX += i;
+        sumY += values[i];
+        sumXY += i * values[i];
+        sumXX += static_cast<double>(i) * i;
+    }
+    double denominator = n * sumXX - sumX * sumX;
+    slope = denominator > 0.0 ? (n * sumXY - sumX * sumY) / denominator : 0.0;
+
+    vector<HistoryAggregate> trend;
+    if (buckets <= 0)
+        return trend;
+    for (int b = 0; b < buckets; b++)
+    {
+        vector<double> bucket(values.begin() + values.size() * b / buckets,
+                              values.begin() + values.size() * (b + 1) / buckets);
+        trend.push_back(Summarize(bucket));
+    }
+    return trend;
+}
+
+// === SPEED PRIORS ===
+namespace
+{
+    int PriorBin(double angle)
+    {
+        long bin = lround(angle / PRIOR_BIN_DEG);
+        return static_cast<int>(clamp<long>(bin, 0, PRIOR_BINS - 1));
+    }
+}
+
+const AnglePrior &SpeedPriors::At(double angle) const
+{
+    return bins[PriorBin(angle)];
+}
+
+void SpeedPriors::Add(double angle, double speed)
+{
+    AnglePrior &bin = bins[PriorBin(angle)];
+    bin.count++;
+    double delta = speed - bin.meanSpeed;
+    bin.meanSpeed += delta / bin.count;
+    bin.m2 += delta * (speed - bin.meanSpeed);
+    if (bin.count > 1)
+        bin.speedStdDev = sqrt(bin.m2 / (bin.count - 1));
+    launches++;
+}
+
+SpeedPriors HistorySpeedPriors(const HistoryReader &reader, const HistoryQuery &query)
+{
+    SpeedPriors priors;
+    const double *angle = reader.Doubles(COL_ANGLE);
+    const double *speed = reader.Doubles(COL_SPEED);
+    // The same update as Add(), with the square roots left for the end.
+    HistoryScan(reader, query, [&](uint64_t row) {
+        AnglePrior &bin = priors.bins[PriorBin(angle[row])];
+        bin.count++;
+        double delta = speed[row] - bin.meanSpeed;
+        bin.meanSpeed += delta / bin.count;
+        bin.m2 += delta * (speed[row] - bin.meanSpeed);
+        priors.launches++;
+    });
+    for (AnglePrior &bin : priors.bins)
+    {
+        if (bin.count > 1)
+            bin.speedStdDev = sqrt(bin.m2 / (bin.count - 1));
+    }
+    return priors;
+}
+
+SpeedPriors LoadSpeedPriors(const string &directory)
+{
+    HistoryReader reader;
+    if (!reader.Open(directory))
+        return SpeedPriors{};
+    return HistorySpeedPriors(reader);
+}
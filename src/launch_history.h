@@ -0,0 +1,194 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "launch_pipeline.h"
+
+// === LAUNCH HISTORY ===
+// Append-only columnar store of every completed launch, kept across runs and
+// events. A store is a directory with one fixed-width file per column (native
+// doubles, or bytes for the flags) plus index.bin, which holds the angle and
+// wall-time range of each HISTORY_BLOCK_ROWS block so filtered queries skip
+// whole blocks. Readers mmap the columns and scan them directly; the row count
+// is the shortest column, so a row torn by a crash is simply not there yet
+// (the next writer trims it).
+
+constexpr const char *HISTORY_PATH = "hotwheels_history";
+constexpr uint32_t HISTORY_BLOCK_ROWS = 4096;
+
+enum HistoryColumn
+{
+    COL_WALL_TIME = 0,  // unix s
+    COL_ANGLE,          // deg, commanded after offset
+    COL_T1,             // s
+    COL_T2,             // s
+    COL_SPEED,          // m/s
+    COL_LANDING,        // m, catcher target
+    COL_TIME_OF_FLIGHT, // s
+    COL_MARGIN,         // s
+    COL_DOOR_OPEN_CMD,  // s after t1
+    COL_DOOR_CLOSE_CMD, // s after t2
+    COL_CATCHER_CMD,    // s after t2
+    COL_CATCHER_SETTLE, // s, 0 = not seen
+    COL_LANDING_ERROR,  // m, detected impact minus landing, NaN unless caught
+    COL_OUTCOME,        // HistoryOutcome flags (byte)
+    COL_RIG,            // byte
+    HISTORY_COLUMNS
+};
+
+enum HistoryOutcome : uint8_t
+{
+    OUTCOME_FEASIBLE = 1, // the plan met its deadline
+    OUTCOME_IO_ERROR = 2, // at least one I/O error during the launch
+    OUTCOME_CAUGHT = 4,   // the catch detector saw the car land in the catcher
+    OUTCOME_MISSED = 8    // it watched the whole window and saw nothing; neither = unknown
+};
+
+struct HistoryColumnInfo
+{
+    const char *name; // also the file name, "<name>.col"
+    uint32_t width;   // 8 = double, 1 = byte
+};
+extern const HistoryColumnInfo HISTORY_COLUMN_INFO[HISTORY_COLUMNS];
+
+int HistoryColumnByName(const std::string &name); // -1 if unknown
+
+// Zone map entry for one block of rows.
+struct HistoryBlock
+{
+    double minAngle;
+    double maxAngle;
+    double minTime;
+    double maxTime;
+};
+
+// === WRITER ===
+// Shared by all rigs of a process: Append() is called once per launch, after
+// the launch, and serializes on a mutex.
+class HistoryWriter
+{
+public:
+    HistoryWriter() { std::fill(columnFds, columnFds + HISTORY_COLUMNS, -1); }
+    ~HistoryWriter() { Close(); }
+
+    bool Open(const std::string &directory); // creates the store if needed
+    void Append(const LaunchRecord &record, int rig);
+    void Close();
+    uint64_t Rows() const { return rows; }
+
+private:
+    bool RebuildIndex();
+
+    std::mutex appendMutex;
+    int columnFds[HISTORY_COLUMNS];
+    int indexFd = -1;
+    uint64_t rows = 0;
+    HistoryBlock block{}; // the block being filled
+};
+
+// === READER ===
+class HistoryReader
+{
+public:
+    ~HistoryReader() { Close(); }
+
+    bool Open(const std::string &directory); // maps the rows present now
+    void Close();
+
+    uint64_t Rows() const { return rows; }
+    const double *Doubles(HistoryColumn column) const { return static_cast<const double *>(maps[column]); }
+    const uint8_t *Bytes(HistoryColumn column) const { return static_cast<const uint8_t *>(maps[column]); }
+    double Value(HistoryColumn column, uint64_t row) const; // either width, as a double
+
+    uint64_t BlockCount() const { return blocks.size(); }
+    const HistoryBlock &Block(uint64_t block) const { return blocks[block]; }
+
+private:
+    const void *maps[HISTORY_COLUMNS] = {};
+    size_t mapBytes[HISTORY_COLUMNS] = {};
+    uint64_t rows = 0;
+    std::vector<HistoryBlock> blocks;
+};
+
+// === QUERIES ===
+struct HistoryQuery
+{
+    double angleMin = -1e300, angleMax = 1e300; // deg, inclusive
+    double timeMin = -1e300, timeMax = 1e300;   // unix s, inclusive
+    uint64_t last = 0;                          // only the newest N rows, 0 = all
+    int rig = -1;                               // -1 = every rig
+};
+
+struct HistoryAggregate
+{
+    uint64_t count = 0;
+    double mean = 0.0, stddev = 0.0, min = 0.0, max = 0.0;
+    double p50 = 0.0, p95 = 0.0, p99 = 0.0;
+};
+
+// Exact aggregate of one column over the matching rows.
+HistoryAggregate HistoryAggregateColumn(const HistoryReader &reader, HistoryColumn column, const HistoryQuery &query);
+
+// The matching rows in time order, cut into `buckets` equal runs; one
+// aggregate per run. `slope` gets the least-squares change per launch.
+std::vector<HistoryAggregate> HistoryTrend(const HistoryReader &reader, HistoryColumn column, const HistoryQuery &query,
+                                           int buckets, double &slope);
+
+// Calls visit(row) for each matching row in order, skipping blocks the index rules out.
+template <typename Visit>
+void HistoryScan(const HistoryReader &reader, const HistoryQuery &query, Visit visit)
+{
+    uint64_t first = (query.last && query.last < reader.Rows()) ? reader.Rows() - query.last : 0;
+    const double *angle = reader.Doubles(COL_ANGLE);
+    const double *time = reader.Doubles(COL_WALL_TIME);
+    const uint8_t *rig = reader.Bytes(COL_RIG);
+    for (uint64_t start = first - first % HISTORY_BLOCK_ROWS; start < reader.Rows(); start += HISTORY_BLOCK_ROWS)
+    {
+        uint64_t index = start / HISTORY_BLOCK_ROWS;
+        if (index < reader.BlockCount())
+        {
+            const HistoryBlock &block = reader.Block(index);
+            if (block.maxAngle < query.angleMin || block.minAngle > query.angleMax || block.maxTime < query.timeMin ||
+                block.minTime > query.timeMax)
+                continue;
+        }
+        uint64_t end = std::min<uint64_t>(start + HISTORY_BLOCK_ROWS, reader.Rows());
+        for (uint64_t row = std::max(start, first); row < end; row++)
+        {
+            if (angle[row] < query.angleMin || angle[row] > query.angleMax || time[row] < query.timeMin ||
+                time[row] > query.timeMax || (query.rig >= 0 && rig[row] != query.rig))
+                continue;
+            visit(row);
+        }
+    }
+}
+
+// === SPEED PRIORS ===
+// Exit speed by ramp angle as seen so far, in PRIOR_BIN_DEG bins. What the
+// demo shows the operator before a launch and what angle selection builds on.
+constexpr double PRIOR_BIN_DEG = 1.0;
+constexpr int PRIOR_BINS = 91; // 0..90 deg, bin b centred on b * PRIOR_BIN_DEG
+
+struct AnglePrior
+{
+    uint32_t count = 0;
+    double meanSpeed = 0.0;   // m/s
+    double speedStdDev = 0.0; // m/s
+    double m2 = 0.0;          // (m/s)^2, sum of squared deviations from the mean
+};
+
+struct SpeedPriors
+{
+    AnglePrior bins[PRIOR_BINS];
+    uint64_t launches = 0;
+
+    const AnglePrior &At(double angle) const;
+    void Add(double angle, double speed); // folds in one more launch
+};
+
+SpeedPriors HistorySpeedPriors(const HistoryReader &reader, const HistoryQuery &query = HistoryQuery{});
+
+// Opens the store at `directory` and builds the priors; empty priors if there is no store.
+SpeedPriors LoadSpeedPriors(const std::string &directory = HISTORY_PATH);
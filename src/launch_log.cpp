@@ -0,0 +1,81 @@
+#include "launch_log.h"
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+static const char *LAUNCH_LOG_HEADER =
+    "launch,wall_time,angle,ramp_actual,catcher_start,t1,t2,"
+    "door_open_cmd,door_open_latency,door_close_cmd,door_close_latency,"
+    "catcher_cmd,catcher_latency,speed,landing,time_of_flight,catcher_move_time,margin,feasible,"
+    "model_landing,landing_correction,early_speed,early_landing,early_correction,early_cmd";
+constexpr int LAUNCH_LOG_COLUMNS = 25;
+constexpr int LAUNCH_LOG_COLUMNS_UNCORRECTED = 19; // logs from before the landing correction
+constexpr int LAUNCH_LOG_COLUMNS_NO_EARLY = 21;    // and from before the early catcher columns
+
+bool LaunchLogWriter::Open(const string &path)
+{
+    Close();
+    file = fopen(path.c_str(), "a");
+    if (!file)
+        return false;
+    if (ftell(file) == 0)
+        fprintf(file, "%s\n", LAUNCH_LOG_HEADER);
+    return true;
+}
+
+void LaunchLogWriter::Write(const LaunchRecord &r)
+{
+    if (!file)
+        return;
+    // %.17g keeps doubles exact so a replay sees the same inputs as the live run.
+    fprintf(file, "%u,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%d,"
+                  "%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n",
+            r.launchId, r.wallTime, r.angle, r.rampActual, r.catcherStart, r.t1, r.t2,
+            r.doorOpenCmd, r.doorOpenLatency, r.doorCloseCmd, r.doorCloseLatency,
+            r.catcherCmd, r.catcherLatency, r.speed, r.landing, r.timeOfFlight, r.catcherMoveTime,
+            r.margin, r.feasible ? 1 : 0, r.modelLanding, r.landingCorrection,
+            r.earlySpeed, r.earlyLanding, r.earlyCorrection, r.earlyCmd);
+    fflush(file);
+}
+
+void LaunchLogWriter::Close()
+{
+    if (file)
+        fclose(file);
+    file = nullptr;
+}
+
+bool LaunchLogRead(const string &path, vector<LaunchRecord> &records)
+{
+    FILE *file = fopen(path.c_str(), "r");
+    if (!file)
+        return false;
+
+    char line[1024];
+    int lineNumber = 0;
+    while (fgets(line, sizeof(line), file))
+    {
+        lineNumber++;
+        if (lineNumber == 1 || line[0] == '\n')
+            continue; // header
+
+        LaunchRecord r;
+        int feasible = 0;
+        int fields = sscanf(line, "%u,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%d,%lf,%lf,%lf,%lf,%lf,%lf",
+                            &r.launchId, &r.wallTime, &r.angle, &r.rampActual, &r.catcherStart, &r.t1, &r.t2,
+                            &r.doorOpenCmd, &r.doorOpenLatency, &r.doorCloseCmd, &r.doorCloseLatency,
+                            &r.catcherCmd, &r.catcherLatency, &r.speed, &r.landing, &r.timeOfFlight,
+                            &r.catcherMoveTime, &r.margin, &feasible, &r.modelLanding, &r.landingCorrection,
+                            &r.earlySpeed, &r.earlyLanding, &r.earlyCorrection, &r.earlyCmd);
+        if (fields != LAUNCH_LOG_COLUMNS && fields != LAUNCH_LOG_COLUMNS_NO_EARLY && fields != LAUNCH_LOG_COLUMNS_UNCORRECTED)
+        {
+            cerr << "[Replay] Skipping malformed line " << lineNumber << " in " << path << "\n";
+            continue;
+        }
+        r.feasible = feasible != 0;
+        records.push_back(r);
+    }
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "launch_pipeline.h"
+
+// === LAUNCH LOG ===
+// One CSV row per launch, appended as the demo runs. Used as replay input.
+
+class LaunchLogWriter
+{
+public:
+    ~LaunchLogWriter() { Close(); }
+
+    bool Open(const std::string &path); // appends, writes the header for a new file
+    void Write(const LaunchRecord &record);
+    void Close();
+
+private:
+    FILE *file = nullptr;
+};
+
+bool LaunchLogRead(const std::string &path, std::vector<LaunchRecord> &records);
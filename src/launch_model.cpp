@@ -0,0 +1,94 @@
+#include "launch_model.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// === PHYSICS ===
+double ComputeSpeed(double t1, double t2, double sensorDistance)
+{
+    return (t2 > t1) ? sensorDistance / (t2 - t1) : 0.0;
+}
+
+double ComputeTimeOfFlight(double speed, double angleDeg, double rampHeight)
+{
+    double angleRad = angleDeg * M_PI / 180.0;
+    double vy = speed * sin(angleRad);
+    double timeUp = vy/GRAVITY;
+    double maxHeight = vy*timeUp + 0.5*GRAVITY*timeUp*timeUp;
+    double timeDown = sqrt((2*(maxHeight+rampHeight))/GRAVITY);
+    return timeUp+timeDown;
+}
+
+double ComputeLandingPosition(double speed, double angleDeg, double rampHeight)
+{
+    double angleRad = angleDeg * M_PI / 180.0;
+    double vx = speed * cos(angleRad);
+    return vx * ComputeTimeOfFlight(speed, angleDeg, rampHeight);
+}
+
+namespace
+{
+    // Highest velocity a trapezoidal move of `distance` reaches.
+    double PeakVelocity(const MotionProfile &profile, double distance)
+    {
+        double triangular = sqrt(2.0 * distance * profile.acceleration * profile.deceleration /
+                                 (profile.acceleration + profile.deceleration));
+        return min(profile.velocity, triangular);
+    }
+}
+
+double ComputeTrapezoidTime(const MotionProfile &profile, double distance)
+{
+    distance = fabs(distance);
+    if (distance <= 0.0)
+        return 0.0;
+    double v = profile.velocity;
+    double accelDistance = 0.5 * v * v / profile.acceleration;
+    double decelDistance = 0.5 * v * v / profile.deceleration;
+    if (accelDistance + decelDistance >= distance)
+    {
+        // Triangular profile: never reaches cruise velocity.
+        double peak = PeakVelocity(profile, distance);
+        return peak / profile.acceleration + peak / profile.deceleration;
+    }
+    return v / profile.acceleration + v / profile.deceleration +
+           (distance - accelDistance - decelDistance) / v;
+}
+
+double ComputeJerkTime(const MotionProfile &profile, double distance)
+{
+    distance = fabs(distance);
+    double jerk = clamp(profile.jerkPercent / 100.0, 0.0, 1.0);
+    if (distance <= 0.0 || jerk <= 0.0)
+        return 0.0;
+    double accelTime = PeakVelocity(profile, distance) / profile.acceleration;
+    return jerk * accelTime / (2.0 - jerk);
+}
+
+double ComputeMoveTime(const MotionProfile &profile, double distance)
+{
+    return ComputeTrapezoidTime(profile, distance) + ComputeJerkTime(profile, distance);
+}
+
+// === LAUNCH PLAN ===
+LaunchPlan PlanLaunch(double t1, double t2, double angleDeg, double catcherStart, const LaunchParams &params,
+                      double correction)
+{
+    return PlanLaunchAtSpeed(ComputeSpeed(t1, t2, params.sensorDistance), angleDeg, catcherStart, params, correction);
+}
+
+LaunchPlan PlanLaunchAtSpeed(double speed, double angleDeg, double catcherStart, const LaunchParams &params,
+                             double correction)
+{
+    LaunchPlan plan;
+    plan.speed = speed;
+    plan.modelLanding = ComputeLandingPosition(plan.speed, angleDeg, params.rampHeight);
+    plan.correction = (plan.speed > 0.0) ? correction : 0.0;
+    plan.rawLanding = plan.modelLanding + plan.correction;
+    plan.landing = clamp(plan.rawLanding, params.minCatcherPosition, params.maxCatcherPosition);
+    plan.timeOfFlight = ComputeTimeOfFlight(plan.speed, angleDeg, params.rampHeight);
+    plan.catcherMoveTime = ComputeMoveTime(params.profiles[CATCHER], plan.landing - catcherStart);
+    plan.inRange = plan.speed > 0.0 && plan.rawLanding == plan.landing;
+    return plan;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include "rig_description.h"
+
+// === CONSTANTS ===
+// Geometry and default profiles are the demo rig's (see rig_description.h).
+constexpr double SENSOR_DISTANCE = DEMO_RIG.sensorDistance; // meters
+constexpr double GRAVITY = 9.81;
+constexpr double MIN_CATCHER_POSITION = DEMO_RIG.axes[CATCHER].minPosition;
+constexpr double MAX_CATCHER_POSITION = DEMO_RIG.axes[CATCHER].maxPosition;
+constexpr double RAMP_HEIGHT = DEMO_RIG.rampHeight; //relative to catcher
+constexpr double ANGLE_OFFSET = 0;      // degrees
+constexpr double DOOR_OPEN_BASE = DEMO_RIG.doorOpenBase; // degrees, door opens to DOOR_OPEN_BASE - rampAngle
+constexpr double SENSOR2_TIMEOUT = 2.0;   // s from sensor 1, car stuck or derailed
+constexpr double POST_LAUNCH_DWELL = 3.0; // s from the catcher command to the next launch
+constexpr double WAKEUP_BUDGET_US = 200.0; // control-loop wake-up latency budget
+constexpr double EXEC_BUDGET_US = 100.0;   // control-loop time awake per poll
+constexpr double CATCH_ERROR_THRESHOLD = 0.001; // m, catcher following error jump taken as an impact
+constexpr double CATCH_OUTPUT_THRESHOLD = 15.0; // % filter output jump taken as an impact, 0 = ignore
+
+//  Motion parameters — tune as needed (hotwheels_params.conf)
+constexpr MotionProfile RAMP_PROFILE = DEMO_RIG.axes[RAMP].profile;       // deg/sec, deg/sec²
+constexpr MotionProfile DOOR_PROFILE = DEMO_RIG.axes[DOOR].profile;       // deg/sec, deg/sec²
+constexpr MotionProfile CATCHER_PROFILE = DEMO_RIG.axes[CATCHER].profile; // m/sec, m/sec²
+
+// === TUNING PARAMETERS ===
+// Everything a launch reads that may be retuned at runtime (see params.h).
+// Defaults are the compiled-in constants above.
+struct LaunchParams
+{
+    MotionProfile profiles[AXIS_COUNT] = {RAMP_PROFILE, DOOR_PROFILE, CATCHER_PROFILE};
+    double sensorDistance = SENSOR_DISTANCE;
+    double rampHeight = RAMP_HEIGHT;
+    double minCatcherPosition = MIN_CATCHER_POSITION;
+    double maxCatcherPosition = MAX_CATCHER_POSITION;
+    double angleOffset = ANGLE_OFFSET;
+    double doorOpenBase = DOOR_OPEN_BASE;
+    double sensor2Timeout = SENSOR2_TIMEOUT;
+    double postLaunchDwell = POST_LAUNCH_DWELL;
+    double wakeupBudgetUs = WAKEUP_BUDGET_US;
+    double execBudgetUs = EXEC_BUDGET_US;
+    double catchErrorThreshold = CATCH_ERROR_THRESHOLD;
+    double catchOutputThreshold = CATCH_OUTPUT_THRESHOLD;
+    bool jitterSnapshot = false; // export a span snapshot after a launch with overruns
+    bool pipelineCars = false;   // admit the next car once the previous one has cleared sensor 2 (car_tracker.h)
+    bool landingCorrection = true; // learn and apply a landing correction from caught cars (landing_correction.h)
+    bool earlyCatcher = true;      // send the catcher on the sensor 1 occlusion speed (occlusion_speed.h)
+};
+
+// Defaults for another rig built from the same source; LaunchParams{} is the demo rig's.
+template <const RigDescription &Rig>
+constexpr LaunchParams RigLaunchParams()
+{
+    static_assert(RigModel<Rig>::VALID);
+    LaunchParams params;
+    for (int a = 0; a < AXIS_COUNT; a++)
+        params.profiles[a] = Rig.axes[a].profile;
+    params.sensorDistance = Rig.sensorDistance;
+    params.rampHeight = Rig.rampHeight;
+    params.minCatcherPosition = Rig.axes[CATCHER].minPosition;
+    params.maxCatcherPosition = Rig.axes[CATCHER].maxPosition;
+    params.doorOpenBase = Rig.doorOpenBase;
+    return params;
+}
+
+// === PHYSICS ===
+double ComputeSpeed(double t1, double t2, double sensorDistance = SENSOR_DISTANCE);
+double ComputeTimeOfFlight(double speed, double angleDeg, double rampHeight = RAMP_HEIGHT);
+double ComputeLandingPosition(double speed, double angleDeg, double rampHeight = RAMP_HEIGHT);
+
+// Time for a trapezoidal move of the given distance, ignoring jerk and settle.
+double ComputeTrapezoidTime(const MotionProfile &profile, double distance);
+
+// Length of each jerk ramp of the S-curve: jerkPercent of every acceleration
+// phase is spent ramping, which keeps the peak acceleration and stretches the
+// phase (100% makes it twice as long).
+double ComputeJerkTime(const MotionProfile &profile, double distance);
+
+// Time for the whole move: trapezoid plus the jerk ramps, ignoring settle.
+double ComputeMoveTime(const MotionProfile &profile, double distance);
+
+inline double DoorOpenAngle(double rampAngle, double doorOpenBase = DOOR_OPEN_BASE) { return doorOpenBase - rampAngle; }
+
+// === LAUNCH PLAN ===
+struct LaunchPlan
+{
+    double speed = 0.0;         // m/s
+    double modelLanding = 0.0;  // m, ComputeLandingPosition()
+    double correction = 0.0;    // m, learned, added to the model
+    double rawLanding = 0.0;    // m, corrected, before clamping to the catcher range
+    double landing = 0.0;       // m, catcher target
+    double timeOfFlight = 0.0;  // s, from leaving the ramp to landing
+    double catcherMoveTime = 0.0; // s, from catcherStart to landing
+    bool inRange = false;
+};
+
+// `correction` is added to the model's landing (m, see landing_correction.h); 0 = model only.
+LaunchPlan PlanLaunch(double t1, double t2, double angleDeg, double catcherStart,
+                      const LaunchParams &params = LaunchParams{}, double correction = 0.0);
+
+// The same from a speed measured some other way (occlusion_speed.h).
+LaunchPlan PlanLaunchAtSpeed(double speed, double angleDeg, double catcherStart,
+                             const LaunchParams &params = LaunchParams{}, double correction = 0.0);
+
+// Time left between the catcher arriving and the car landing, given how long
+// after sensor 2 the catcher command went out. Negative = catcher arrives late.
+inline double CatchMargin(const LaunchPlan &plan, double commandDelay)
+{
+    return plan.timeOfFlight - (commandDelay + plan.catcherMoveTime);
+}
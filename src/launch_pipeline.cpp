@@ -0,0 +1,472 @@
+#include "launch_pipeline.h"
+#include "alloc_guard.h"
+#include "car_tracker.h"
+#include "catch_detector.h"
+#include "jitter_monitor.h"
+#include "landing_correction.h"
+#include "metrics.h"
+#include "occlusion_speed.h"
+#include "span_trace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+
+const char *IoErrorName(IoError error)
+{
+    switch (error)
+    {
+    case IO_OK:
+        return "ok";
+    case IO_SENSOR_READ:
+        return "sensor read failed";
+    case IO_AXIS_MOVE:
+        return "axis move failed";
+    case IO_POSITION_READ:
+        return "position read failed";
+    case IO_MOTION_STATE_READ:
+        return "motion state read failed";
+    case IO_STATUS_READ:
+        return "status block read failed";
+    case IO_AXIS_FAULT:
+        return "axis fault";
+    }
+    return "unknown";
+}
+
+const char *CatchOutcomeName(CatchOutcome outcome)
+{
+    switch (outcome)
+    {
+    case CATCH_UNKNOWN:
+        return "unknown";
+    case CATCH_CAUGHT:
+        return "caught";
+    case CATCH_MISSED:
+        return "missed";
+    }
+    return "unknown";
+}
+
+namespace
+{
+    // The control loop: evaluates `ready` every SENSOR_POLL_PERIOD_NS until it
+    // holds, feeding each iteration's wake-up latency and time awake to the
+    // jitter monitor. Returns the clock time `ready` held at, 0 = aborted or timed out.
+    template <typename Ready>
+    int64_t PollLoop(LaunchIO &io, int64_t timeoutNs, Ready ready)
+    {
+        Clock &clock = GetClock();
+        int64_t woke = clock.NowNs();
+        int64_t deadline = (timeoutNs == INT64_MAX) ? INT64_MAX : woke + timeoutNs;
+        while (!io.Aborted() && woke < deadline)
+        {
+            bool done = ready();
+            int64_t polled = clock.NowNs();
+            if (done)
+                return polled;
+            int64_t next = woke + SENSOR_POLL_PERIOD_NS;
+            clock.SleepUntil(next);
+            int64_t now = clock.NowNs();
+            JitterRecord(now - next, polled - woke);
+            woke = now;
+        }
+        return 0;
+    }
+
+    bool SensorsRead(IoError error)
+    {
+        return error != IO_SENSOR_READ && error != IO_STATUS_READ;
+    }
+
+    // Every wait's status read, shown to the car tracker, catch detector and occlusion timer if attached.
+    IoError ReadTracked(LaunchIO &io, StatusSnapshot &status)
+    {
+        IoError error = io.ReadStatus(status);
+        if (!io.tracker && !io.catchDetector && !io.occlusion)
+            return error;
+        int64_t now = GetClock().NowNs();
+        if (io.tracker && SensorsRead(error))
+            io.tracker->Poll(status, now);
+        if (io.occlusion && SensorsRead(error))
+            io.occlusion->Poll(status, now);
+        if (io.catchDetector && error == IO_OK)
+            io.catchDetector->Sample(status, now);
+        return error;
+    }
+
+    void NoteError(LaunchRecord &record, IoError error)
+    {
+        if (error == IO_OK)
+            return;
+        if (record.ioErrorCount++ == 0)
+            record.ioError = error;
+    }
+
+    template <typename T>
+    T Checked(IoResult<T> result, LaunchRecord &record)
+    {
+        NoteError(record, result.error);
+        return result.value;
+    }
+
+    // Sensor reads fail inside WaitSensor, which has no record to note them in.
+    void NoteSensorErrors(LaunchIO &io, LaunchRecord &record, uint32_t before)
+    {
+        if (io.sensorReadErrors == before)
+            return;
+        if (record.ioErrorCount == 0)
+            record.ioError = IO_SENSOR_READ;
+        record.ioErrorCount += io.sensorReadErrors - before;
+    }
+
+    // Everything that went wrong during a launch, reported once it no longer matters for timing.
+    void ReportIssues(LaunchIO &io, const LaunchRecord &record, const LaunchParams &params)
+    {
+        if (record.ioErrorCount)
+            cerr << "[Error] " << record.ioErrorCount << " I/O error(s) during launch " << record.launchId
+                 << ", first: " << IoErrorName(record.ioError) << " (last: " << io.ErrorDetail() << ")\n";
+
+        JitterOverruns overruns = JitterTakeOverruns();
+        if (overruns.count == 0)
+            return;
+        cerr << "[Jitter] " << overruns.count << " control-loop iteration(s) over budget during launch " << record.launchId
+             << " | worst wake-up " << overruns.worstWakeupNs / 1000.0 << " us (budget " << params.wakeupBudgetUs
+             << ") | worst exec " << overruns.worstExecNs / 1000.0 << " us (budget " << params.execBudgetUs << ")\n";
+        if (params.jitterSnapshot)
+        {
+            char path[64];
+            snprintf(path, sizeof(path), "hotwheels_jitter_%u.json", record.launchId);
+            if (SpanTraceExport(path))
+                cerr << "[Jitter] Span snapshot written to " << path << "\n";
+        }
+    }
+}
+
+IoError LaunchIO::ReadStatus(StatusSnapshot &status)
+{
+    IoError first = IO_OK;
+    auto note = [&first](IoError error) {
+        if (first == IO_OK)
+            first = error;
+    };
+    for (int s = 0; s < 2; s++)
+    {
+        IoResult<bool> level = SensorLevel(s + 1);
+        status.sensors[s] = level.value;
+        note(level.error);
+    }
+    for (int a = 0; a < AXIS_COUNT; a++)
+    {
+        IoResult<double> position = AxisActualPosition(static_cast<AxisID>(a));
+        IoResult<bool> done = MotionDone(static_cast<AxisID>(a));
+        status.actualPosition[a] = position.value;
+        status.followingError[a] = 0.0;
+        status.filterOutput[a] = 0.0;
+        status.motionDone[a] = done.value;
+        status.fault[a] = false;
+        note(position.error);
+        note(done.error);
+    }
+    status.sampleCounter = 0;
+    return first;
+}
+
+double LaunchIO::LandingCorrectionAt(double speed, double angleDeg)
+{
+    return landingCorrection ? landingCorrection->Apply(speed, angleDeg) : 0.0;
+}
+
+double LaunchIO::WaitEarlySpeed(int64_t edge1Ns, double timeout)
+{
+    if (!occlusion || !occlusion->Calibrated() || WaitCleared(1, edge1Ns, timeout) == 0)
+        return 0.0;
+    return occlusion->Speed(occlusion->Occlusion(1, edge1Ns));
+}
+
+int64_t LaunchIO::WaitSensor(int sensor, double timeout)
+{
+    int64_t timeoutNs = (timeout > 0.0) ? SecondsToNs(timeout) : INT64_MAX;
+    int64_t tracked = 0;
+    int64_t edge = PollLoop(*this, timeoutNs, [this, sensor, &tracked]() {
+        StatusSnapshot status;
+        IoError error = ReadTracked(*this, status);
+        if (!SensorsRead(error))
+        {
+            sensorReadErrors++;
+            return false;
+        }
+        // A faulted axis cannot finish this launch; stop waiting for it.
+        for (int a = 0; a < AXIS_COUNT; a++)
+            axisFaults |= status.fault[a] ? 1u << a : 0u;
+        if (tracker)
+            tracked = tracker->LaunchingEdge(sensor);
+        return axisFaults != 0 || (tracker ? tracked != 0 : status.sensors[sensor - 1]);
+    });
+    if (axisFaults || tracked < 0)
+        return 0; // a car the tracker lost cannot be timed either
+    return tracker ? tracked : edge;
+}
+
+bool LaunchIO::WaitMotionDone(AxisID axis, double timeout)
+{
+    return PollLoop(*this, SecondsToNs(timeout), [this, axis]() {
+        StatusSnapshot status;
+        // An unreadable or faulted axis is not worth waiting out the timeout for.
+        return ReadTracked(*this, status) != IO_OK || status.motionDone[axis] || status.fault[axis];
+    }) != 0;
+}
+
+bool LaunchIO::WaitAdmit(double timeout)
+{
+    return !tracker || tracker->CanAdmit() || PollLoop(*this, SecondsToNs(timeout), [this]() {
+        StatusSnapshot status;
+        ReadTracked(*this, status);
+        return tracker->CanAdmit();
+    }) != 0;
+}
+
+bool LaunchIO::WaitCatch(double timeout)
+{
+    return !catchDetector || catchDetector->Done() || PollLoop(*this, SecondsToNs(timeout), [this]() {
+        StatusSnapshot status;
+        ReadTracked(*this, status);
+        return catchDetector->Done();
+    }) != 0;
+}
+
+int64_t LaunchIO::WaitCleared(int sensor, int64_t edgeNs, double timeout)
+{
+    if (!occlusion)
+        return 0;
+    int other = (sensor == 1) ? 1 : 0;
+    bool otherFirst = false;
+    int64_t cleared = PollLoop(*this, SecondsToNs(timeout), [this, sensor, edgeNs, other, &otherFirst]() {
+        StatusSnapshot status;
+        IoError error = ReadTracked(*this, status);
+        if (!SensorsRead(error))
+        {
+            sensorReadErrors++;
+            return false;
+        }
+        for (int a = 0; a < AXIS_COUNT; a++)
+            axisFaults |= status.fault[a] ? 1u << a : 0u;
+        otherFirst = status.sensors[other];
+        return axisFaults != 0 || otherFirst || occlusion->Occlusion(sensor, edgeNs) > 0.0;
+    });
+    return (axisFaults || otherFirst) ? 0 : cleared;
+}
+
+bool LaunchIO::WaitLanded(double timeout)
+{
+    return !tracker || tracker->InFlight() == 0 || PollLoop(*this, SecondsToNs(timeout), [this]() {
+        StatusSnapshot status;
+        ReadTracked(*this, status);
+        return tracker->InFlight() == 0;
+    }) != 0;
+}
+
+bool RunLaunch(LaunchIO &io, double rampAngle, LaunchRecord &record, const LaunchParams &params)
+{
+    Clock &clock = GetClock();
+    uint32_t sensorErrorsBefore = io.sensorReadErrors;
+    io.axisFaults = 0;
+    JitterSetBudget(static_cast<int64_t>(params.wakeupBudgetUs * 1000.0), static_cast<int64_t>(params.execBudgetUs * 1000.0));
+    record.angle = rampAngle;
+    record.catcherStart = Checked(io.AxisActualPosition(CATCHER), record);
+
+    // 1. Set ramp angle
+    int64_t phaseStart = clock.NowNs();
+    {
+        TRACE_SPAN("ramp_move");
+        NoteError(record, io.MoveAxis(RAMP, rampAngle, params.profiles[RAMP]));
+        NoteError(record, io.MoveAxis(DOOR, 0, params.profiles[DOOR]));
+    }
+    MetricsAxisTarget(RAMP, rampAngle);
+    MetricsAxisTarget(DOOR, 0);
+    int64_t phaseEnd = clock.NowNs();
+    MetricsPhase(PHASE_RAMP_MOVE, phaseEnd - phaseStart);
+
+    // 2. Wait for sensor 1 — car approaching gate. Edges stay integer clock
+    // ns; only differences are converted to seconds.
+    int64_t edge1 = 0, edge2 = 0;
+    if (io.verbose)
+        cout << "[Sensor] Waiting for sensor 1..." << endl;
+    phaseStart = phaseEnd;
+    {
+        TRACE_SPAN("sensor1_wait");
+        edge1 = io.WaitSensor(1);
+    }
+    record.t1 = edge1 * 1e-9;
+    if (edge1 == 0)
+    {
+        if (io.axisFaults)
+            NoteError(record, IO_AXIS_FAULT);
+        NoteSensorErrors(io, record, sensorErrorsBefore);
+        ReportIssues(io, record, params);
+        return false;
+    }
+    phaseEnd = clock.NowNs();
+    MetricsPhase(PHASE_SENSOR1_WAIT, phaseEnd - phaseStart);
+
+    // From here to the catcher command nothing allocates, throws or prints;
+    // console output waits until the command is out.
+    HOT_PATH_BEGIN("sensor1_to_catcher");
+
+    // 3. Open door to let car through
+    phaseStart = phaseEnd;
+    {
+        TRACE_SPAN("door_open");
+        NoteError(record, io.MoveAxis(DOOR, DoorOpenAngle(rampAngle, params.doorOpenBase), params.profiles[DOOR]));
+    }
+    phaseEnd = clock.NowNs();
+    record.doorOpenCmd = (phaseStart - edge1) * 1e-9;
+    record.doorOpenLatency = (phaseEnd - phaseStart) * 1e-9;
+    MetricsAxisTarget(DOOR, DoorOpenAngle(rampAngle, params.doorOpenBase));
+    MetricsPhase(PHASE_DOOR_OPEN, phaseEnd - phaseStart);
+
+    // 4. Wait for sensor 2 — car passed. With the car length calibrated, the
+    // car clearing sensor 1 already gives its speed: the catcher leaves on
+    // that estimate and sensor 2 corrects it (occlusion_speed.h).
+    phaseStart = phaseEnd;
+    double sensor2Timeout = params.sensor2Timeout;
+    int64_t earlyStart = 0;
+    if (params.earlyCatcher)
+    {
+        TRACE_SPAN("early_catcher");
+        double speed = io.WaitEarlySpeed(edge1, sensor2Timeout);
+        if (speed > 0.0)
+        {
+            LaunchPlan early = PlanLaunchAtSpeed(speed, rampAngle, record.catcherStart, params,
+                                                 io.LandingCorrectionAt(speed, rampAngle));
+            if (early.inRange)
+            {
+                earlyStart = clock.NowNs();
+                NoteError(record, io.MoveAxis(CATCHER, early.landing, params.profiles[CATCHER]));
+                record.earlySpeed = early.speed;
+                record.earlyLanding = early.landing;
+                record.earlyCorrection = early.correction;
+                record.earlyCmd = (earlyStart - edge1) * 1e-9;
+                MetricsAxisTarget(CATCHER, early.landing);
+            }
+        }
+        sensor2Timeout = max(sensor2Timeout - (clock.NowNs() - phaseStart) * 1e-9, 1e-6);
+    }
+    {
+        TRACE_SPAN("sensor2_wait");
+        edge2 = io.WaitSensor(2, sensor2Timeout);
+    }
+    record.t2 = edge2 * 1e-9;
+    if (edge2 == 0)
+    {
+        HOT_PATH_END();
+        if (io.axisFaults)
+            NoteError(record, IO_AXIS_FAULT);
+        else if (!io.Aborted())
+        {
+            cerr << "[Warning] Sensor timeout.\n";
+            MetricsSensorTimeout();
+            NoteError(record, io.MoveAxis(DOOR, 0.0, params.profiles[DOOR]));
+            MetricsAxisTarget(DOOR, 0.0);
+        }
+        NoteSensorErrors(io, record, sensorErrorsBefore);
+        ReportIssues(io, record, params);
+        return false;
+    }
+    phaseEnd = clock.NowNs();
+    MetricsPhase(PHASE_SENSOR2_WAIT, phaseEnd - phaseStart);
+
+    // 5. Close door again
+    phaseStart = phaseEnd;
+    {
+        TRACE_SPAN("door_close");
+        NoteError(record, io.MoveAxis(DOOR, 0.0, params.profiles[DOOR]));
+    }
+    phaseEnd = clock.NowNs();
+    record.doorCloseCmd = (phaseStart - edge2) * 1e-9;
+    record.doorCloseLatency = (phaseEnd - phaseStart) * 1e-9;
+    MetricsAxisTarget(DOOR, 0.0);
+    MetricsPhase(PHASE_DOOR_CLOSE, phaseEnd - phaseStart);
+
+    // 6. Compute physics
+    phaseStart = phaseEnd;
+    LaunchPlan plan;
+    {
+        TRACE_SPAN("physics");
+        double speed = ComputeSpeed(0.0, (edge2 - edge1) * 1e-9, params.sensorDistance);
+        plan = PlanLaunchAtSpeed(speed, rampAngle, record.catcherStart, params, io.LandingCorrectionAt(speed, rampAngle));
+    }
+    record.speed = plan.speed;
+    record.landing = plan.landing;
+    record.modelLanding = plan.modelLanding;
+    record.landingCorrection = plan.correction;
+    record.timeOfFlight = plan.timeOfFlight;
+    record.catcherMoveTime = plan.catcherMoveTime;
+    phaseEnd = clock.NowNs();
+    MetricsPhase(PHASE_PHYSICS, phaseEnd - phaseStart);
+
+    // 7. Move catcher, unless the early move already goes close enough
+    bool earlyStands = earlyStart != 0 && fabs(plan.landing - record.earlyLanding) <= EARLY_REFINE_TOLERANCE;
+    phaseStart = clock.NowNs();
+    if (!earlyStands)
+    {
+        TRACE_SPAN("catcher_move");
+        NoteError(record, io.MoveAxis(CATCHER, plan.landing, params.profiles[CATCHER]));
+    }
+    phaseEnd = clock.NowNs();
+    HOT_PATH_END();
+    record.catcherCmd = (phaseStart - edge2) * 1e-9;
+    record.catcherLatency = earlyStands ? 0.0 : (phaseEnd - phaseStart) * 1e-9;
+    record.earlyKept = earlyStands;
+    if (earlyStands)
+        record.landing = record.earlyLanding; // the catcher is following the command sent before sensor 2
+    else
+        MetricsAxisTarget(CATCHER, plan.landing);
+    MetricsPhase(PHASE_CATCHER_MOVE, phaseEnd - phaseStart);
+
+    record.margin = CatchMargin(plan, CatcherCommandTime(record));
+    record.feasible = plan.inRange && record.margin >= 0.0;
+    record.rampActual = Checked(io.AxisActualPosition(RAMP), record);
+    MetricsLaunch(rampAngle, plan.speed, plan.landing, record.margin);
+
+    if (io.verbose)
+    {
+        cout << "[Gate] Door opened " << record.doorOpenCmd * 1000.0 << " ms after sensor 1, closed "
+             << record.doorCloseCmd * 1000.0 << " ms after sensor 2." << endl;
+        cout << "[Physics] Speed: " << plan.speed << " m/s | Landing: " << plan.landing << " m" << endl;
+        if (earlyStart != 0)
+            cout << "[Catcher] Early move to " << record.earlyLanding << " m on " << record.earlySpeed
+                 << " m/s from the sensor 1 occlusion, " << record.earlyCmd * 1000.0 << " ms after sensor 1"
+                 << (earlyStands ? ", kept" : ", corrected") << endl;
+        if (!earlyStands)
+            cout << "[Catcher] Moving Catcher (" << record.catcherCmd * 1000.0 << " ms after sensor 2)" << endl;
+    }
+    NoteSensorErrors(io, record, sensorErrorsBefore);
+    ReportIssues(io, record, params);
+    return true;
+}
+
+void PaceLaunch(LaunchIO &io, LaunchRecord &record, const LaunchParams &params)
+{
+    Clock &clock = GetClock();
+    if (record.t2 == 0.0)
+    {
+        clock.SleepFor(SecondsToNs(params.postLaunchDwell));
+        return;
+    }
+    double commandTime = record.t2 + CatcherCommandTime(record);
+    CatchDetector detector;
+    detector.Arm(record, SecondsToNs(record.t2), params);
+    io.catchDetector = &detector;
+    if (io.WaitMotionDone(CATCHER, MOTION_DONE_TIMEOUT))
+    {
+        record.catcherSettle = io.Now() - commandTime;
+        record.catcherError = Checked(io.AxisActualPosition(CATCHER), record) - record.landing;
+    }
+    io.WaitCatch(record.timeOfFlight + CATCH_WINDOW_AFTER);
+    io.catchDetector = nullptr;
+    detector.Finish(record);
+    clock.SleepUntil(SecondsToNs(commandTime + params.postLaunchDwell));
+}
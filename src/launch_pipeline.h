@@ -0,0 +1,204 @@
+#pragma once
+#include <cstdint>
+#include "clock.h"
+#include "launch_model.h"
+
+constexpr int64_t SENSOR_POLL_PERIOD_NS = 1 * NS_PER_MS;
+constexpr double MOTION_DONE_TIMEOUT = 2.0; // s
+
+class CarTracker;
+class CatchDetector;
+class LandingCorrection;
+class OcclusionSpeed;
+
+// === I/O RESULTS ===
+// LaunchIO calls never throw into the pipeline: implementations catch at the
+// SDK boundary and return a code, which RunLaunch counts and reports once the
+// catcher command is out.
+enum IoError : uint8_t
+{
+    IO_OK = 0,
+    IO_SENSOR_READ,
+    IO_AXIS_MOVE,
+    IO_POSITION_READ,
+    IO_MOTION_STATE_READ,
+    IO_STATUS_READ,
+    IO_AXIS_FAULT
+};
+
+const char *IoErrorName(IoError error);
+
+// How a launch ended, as told by the catch detector (catch_detector.h).
+enum CatchOutcome : uint8_t
+{
+    CATCH_UNKNOWN = 0, // not watched, catcher faulted or samples missing
+    CATCH_CAUGHT,
+    CATCH_MISSED
+};
+
+const char *CatchOutcomeName(CatchOutcome outcome);
+
+template <typename T>
+struct IoResult
+{
+    T value{};
+    IoError error = IO_OK;
+
+    bool Ok() const { return error == IO_OK; }
+};
+
+// === LAUNCH RECORD ===
+// Everything needed to re-run a launch offline. Command times are relative to
+// the sensor edge that triggered them; latencies are how long the axis call took.
+struct LaunchRecord
+{
+    uint32_t launchId = 0;
+    double wallTime = 0.0;       // unix seconds at launch start
+    double angle = 0.0;          // deg, commanded ramp angle after offset
+    double rampActual = 0.0;     // deg, ramp encoder after the launch
+    double catcherStart = 0.0;   // m, catcher position before the launch
+    double t1 = 0.0;             // s, sensor 1 edge
+    double t2 = 0.0;             // s, sensor 2 edge
+    double doorOpenCmd = 0.0;    // s after t1
+    double doorOpenLatency = 0.0;
+    double doorCloseCmd = 0.0;   // s after t2
+    double doorCloseLatency = 0.0;
+    double catcherCmd = 0.0;     // s after t2, the sensor 2 command, or keeping the early one (earlyKept)
+    double catcherLatency = 0.0; // 0 when the early command was kept
+    double speed = 0.0;          // m/s
+    double landing = 0.0;        // m, catcher target
+    double modelLanding = 0.0;   // m, launch model before the learned correction and clamping
+    double landingCorrection = 0.0; // m, learned correction included in landing
+    double timeOfFlight = 0.0;   // s
+    double catcherMoveTime = 0.0; // s
+    double margin = 0.0;         // s, see CatchMargin()
+    bool feasible = false;
+    IoError ioError = IO_OK;     // first I/O error in the launch (not logged)
+    uint32_t ioErrorCount = 0;
+    double catcherSettle = 0.0;  // s from the catcher command to motion done, 0 = not seen (not logged)
+    double catcherError = 0.0;   // m, settled catcher position minus landing (not logged)
+    CatchOutcome outcome = CATCH_UNKNOWN; // (not logged)
+    double impactTime = 0.0;     // s, detected impact minus predicted landing time (not logged)
+    double impactPosition = 0.0; // m, estimated from the measured flight, 0 = no impact (not logged)
+    double occlusion[2] = {};    // s each beam was blocked, 0 = not measured (not logged)
+    double earlySpeed = 0.0;     // m/s from the sensor 1 occlusion, 0 = no early command
+    double earlyLanding = 0.0;   // m, catcher target of the early command
+    double earlyCorrection = 0.0; // m, learned correction included in earlyLanding
+    double earlyCmd = 0.0;       // s after t1
+    bool earlyKept = false;      // the catcher followed the early command, nothing was sent at sensor 2 (not logged)
+};
+
+// When the command the catcher followed went out, s after t2: negative when
+// the early command was kept. Margin, settle time and the dwell run from it.
+inline double CatcherCommandTime(const LaunchRecord &record)
+{
+    return record.earlyKept ? record.t1 + record.earlyCmd - record.t2 : record.catcherCmd;
+}
+
+// === STATUS SNAPSHOT ===
+// Everything one control-loop iteration looks at, sampled together.
+struct StatusSnapshot
+{
+    uint32_t sampleCounter = 0;           // controller sample the values belong to, 0 = not available
+    bool sensors[2] = {};                 // sensor 1, sensor 2
+    double actualPosition[AXIS_COUNT] = {};
+    double followingError[AXIS_COUNT] = {}; // commanded minus actual, 0 where not measured
+    bool motionDone[AXIS_COUNT] = {};
+    bool fault[AXIS_COUNT] = {};          // axis cannot finish its move (e.g. following error)
+    double filterOutput[AXIS_COUNT] = {};   // drive demand (% of output), 0 where not measured
+};
+
+// === AXIS HEALTH ===
+struct AxisHealth
+{
+    bool fault = false;     // following error, limit or drive fault latched
+    bool ampEnabled = true;
+};
+
+// === LAUNCH I/O ===
+// The pipeline only talks to the rig through this interface, so the same code
+// runs live against the RMP, against the simulated rig and offline against
+// recorded launches.
+class LaunchIO
+{
+public:
+    virtual ~LaunchIO() = default;
+
+    // Called between sensor 1 and the catcher command: no allocation, no throwing.
+    virtual IoResult<bool> SensorLevel(int sensor) = 0;
+    virtual IoError MoveAxis(AxisID axis, double pos, const MotionProfile &profile) = 0;
+    virtual IoResult<double> AxisActualPosition(AxisID axis) = 0;
+    virtual IoResult<bool> MotionDone(AxisID axis) = 0;
+    virtual bool Aborted() { return false; }
+
+    // One snapshot per poll. The default asks the accessors above in turn and
+    // returns the first error; the live rig reads it as one block of controller memory.
+    virtual IoError ReadStatus(StatusSnapshot &status);
+
+    // Text of the most recent error (e.g. the SDK message), for reporting after the launch.
+    virtual const char *ErrorDetail() { return ""; }
+
+    // Bracket each launch, e.g. for the live rig's trace windows.
+    virtual void LaunchBegin(uint32_t launchId) {}
+    virtual void LaunchEnd() {}
+
+    // Fault recovery, between launches only (see fault_supervisor.h). The
+    // defaults describe axes that never fault. ReferenceAxis re-synchronizes
+    // whatever position reference the I/O keeps after a fault clear.
+    virtual IoResult<AxisHealth> ReadAxisHealth(AxisID axis) { return {AxisHealth{}}; }
+    virtual IoError ClearAxisFault(AxisID axis) { return IO_OK; }
+    virtual IoError EnableAxis(AxisID axis) { return IO_OK; }
+    virtual IoError ReferenceAxis(AxisID axis) { return IO_OK; }
+
+    // m that RunLaunch's plan adds to the model's landing for a car at `speed`
+    // off a ramp at `angleDeg`: the attached learned correction, 0 without
+    // one. On the hot path; replay returns what the original launch used.
+    virtual double LandingCorrectionAt(double speed, double angleDeg);
+
+    // Early catcher: waits for the car that tripped sensor 1 at `edge1Ns` to
+    // clear it and returns its speed from the occlusion, m/s, 0 = no usable
+    // estimate (no calibrated occlusion timer, timed out, the car reached
+    // sensor 2 first). On the hot path; replay returns the recorded one.
+    virtual double WaitEarlySpeed(int64_t edge1Ns, double timeout);
+
+    // Polls ReadStatus() on the global clock; returns the edge timestamp in
+    // clock ns, 0 = aborted, timed out or an axis faulted (see axisFaults).
+    // timeout <= 0 waits indefinitely. A failed read counts as "no car" and is
+    // added to sensorReadErrors.
+    // With a tracker attached the edge is the one it assigned to the newest car.
+    virtual int64_t WaitSensor(int sensor, double timeout = 0.0);
+    bool WaitMotionDone(AxisID axis, double timeout);
+
+    // Tracker waits: until it can admit the next car, or until no car is in flight.
+    bool WaitAdmit(double timeout);
+    bool WaitLanded(double timeout);
+
+    // Until the attached catch detector has an answer.
+    bool WaitCatch(double timeout);
+
+    // Until the beam break on `sensor` that started at `edgeNs` is over, as
+    // seen by the attached occlusion timer. Returns that clock ns, 0 = timed
+    // out, aborted, an axis faulted or the other beam tripped first.
+    int64_t WaitCleared(int sensor, int64_t edgeNs, double timeout);
+
+    double Now() { return GetClock().NowSeconds(); } // s, same timebase as sensor edges
+
+    bool verbose = true;
+    uint32_t sensorReadErrors = 0;
+    uint32_t axisFaults = 0; // bit per AxisID faulted during the current launch; set by WaitSensor
+    CarTracker *tracker = nullptr; // pipelined cars (see car_tracker.h); sees every status poll of the waits
+    CatchDetector *catchDetector = nullptr; // the launch being paced (catch_detector.h); sees them too
+    const LandingCorrection *landingCorrection = nullptr; // applied through LandingCorrectionAt() (landing_correction.h)
+    OcclusionSpeed *occlusion = nullptr; // beam occlusion timer (occlusion_speed.h); sees every status poll of the waits
+};
+
+// Runs one launch from ramp positioning to the catcher command. Returns false
+// if a sensor wait was aborted (including by an axis fault, which is noted as
+// IO_AXIS_FAULT); the record holds whatever was reached.
+bool RunLaunch(LaunchIO &io, double rampAngle, LaunchRecord &record, const LaunchParams &params);
+
+// Waits for the catcher to stop, fills in its settle time and position error,
+// watches for the car to land in it (record.outcome), and holds the
+// post-launch dwell, measured from the catcher command so the launch cadence
+// does not drift.
+void PaceLaunch(LaunchIO &io, LaunchRecord &record, const LaunchParams &params);
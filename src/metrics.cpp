@@ -0,0 +1,204 @@
+#include "metrics.h"
+#include "clock.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+
+const char *const LAUNCH_PHASE_NAMES[PHASE_COUNT] = {
+    "ramp_move", "sensor1_wait", "door_open", "sensor2_wait", "door_close", "physics", "catcher_move"};
+
+namespace
+{
+    // Per thread: each rig's control thread publishes its own page.
+    thread_local MetricsPage *gPage = nullptr;
+    thread_local string gPageName;
+
+    // Seqlock write section: readers retry while the sequence is odd or changes.
+    struct WriteGuard
+    {
+        WriteGuard()
+        {
+            atomic_ref<uint32_t> sequence(gPage->sequence);
+            sequence.store(gPage->sequence + 1, memory_order_relaxed);
+            atomic_thread_fence(memory_order_release);
+        }
+        ~WriteGuard()
+        {
+            atomic_ref<uint32_t>(gPage->sequence).store(gPage->sequence + 1, memory_order_release);
+        }
+    };
+}
+
+std::string MetricsRigName(int rig)
+{
+    return rig == 0 ? string(METRICS_SHM_NAME) : string(METRICS_SHM_NAME) + "_rig" + to_string(rig);
+}
+
+// === WRITER ===
+bool MetricsOpen(const char *name, int rig)
+{
+    if (gPage)
+        return true;
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        cerr << "[Metrics] shm_open failed for " << name << ": " << strerror(errno) << endl;
+        return false;
+    }
+    if (ftruncate(fd, sizeof(MetricsPage)) != 0)
+    {
+        cerr << "[Metrics] ftruncate failed: " << strerror(errno) << endl;
+        close(fd);
+        return false;
+    }
+    void *mapping = mmap(nullptr, sizeof(MetricsPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        cerr << "[Metrics] mmap failed: " << strerror(errno) << endl;
+        return false;
+    }
+
+    gPage = static_cast<MetricsPage *>(mapping);
+    memset(gPage, 0, sizeof(MetricsPage));
+    gPage->magic = METRICS_MAGIC;
+    gPage->version = METRICS_VERSION;
+    gPage->pid = getpid();
+    gPage->rig = rig;
+    gPageName = name;
+    cout << "[Metrics] Publishing live metrics at /dev/shm" << name << "\n";
+    return true;
+}
+
+void MetricsClose()
+{
+    if (!gPage)
+        return;
+    munmap(gPage, sizeof(MetricsPage));
+    shm_unlink(gPageName.c_str());
+    gPage = nullptr;
+}
+
+void MetricsPhase(LaunchPhase phase, int64_t durationNs)
+{
+    if (!gPage)
+        return;
+    WriteGuard guard;
+    PhaseStats &stats = gPage->phases[phase];
+    stats.count++;
+    stats.lastNs = durationNs;
+    stats.totalNs += durationNs;
+    if (durationNs > stats.maxNs)
+        stats.maxNs = durationNs;
+}
+
+void MetricsAxisTarget(AxisID axis, double target)
+{
+    if (!gPage)
+        return;
+    WriteGuard guard;
+    gPage->axisTarget[axis] = target;
+}
+
+void MetricsLaunch(double angle, double speed, double landing, double margin)
+{
+    if (!gPage)
+        return;
+    WriteGuard guard;
+    gPage->updatedNs = GetClock().NowNs();
+    gPage->launches++;
+    gPage->lastAngle = angle;
+    gPage->lastSpeed = speed;
+    gPage->lastLanding = landing;
+    gPage->lastMargin = margin;
+}
+
+void MetricsOutcome(CatchOutcome outcome)
+{
+    if (!gPage)
+        return;
+    WriteGuard guard;
+    if (outcome == CATCH_CAUGHT)
+        gPage->catches++;
+    else if (outcome == CATCH_MISSED)
+        gPage->misses++;
+    else
+        gPage->undetected++;
+}
+
+void MetricsSensorTimeout()
+{
+    if (!gPage)
+        return;
+    WriteGuard guard;
+    gPage->sensorTimeouts++;
+}
+
+void MetricsLoopIteration(int64_t wakeupNs, int64_t execNs, bool lateWakeup, bool longExec)
+{
+    if (!gPage)
+        return;
+    WriteGuard guard;
+    JitterAdd(gPage->loopWakeup, wakeupNs, lateWakeup);
+    JitterAdd(gPage->loopExec, execNs, longExec);
+}
+
+void MetricsStatistics(const uint8_t *blob, size_t size)
+{
+    if (!gPage)
+        return;
+    WriteGuard guard;
+    if (size > METRICS_STATS_CAPACITY)
+    {
+        gPage->statsBytes = 0;
+        return;
+    }
+    memcpy(gPage->stats, blob, size);
+    gPage->statsBytes = static_cast<uint32_t>(size);
+}
+
+bool MetricsActive()
+{
+    return gPage != nullptr;
+}
+
+// === READER ===
+const MetricsPage *MetricsMapReadOnly(const char *name)
+{
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+        return nullptr;
+    void *mapping = mmap(nullptr, sizeof(MetricsPage), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return nullptr;
+    const MetricsPage *page = static_cast<const MetricsPage *>(mapping);
+    if (page->magic != METRICS_MAGIC || page->version != METRICS_VERSION)
+    {
+        munmap(mapping, sizeof(MetricsPage));
+        return nullptr;
+    }
+    return page;
+}
+
+bool MetricsSnapshot(const MetricsPage *page, MetricsPage &out)
+{
+    uint32_t *sequencePtr = const_cast<uint32_t *>(&page->sequence);
+    for (int attempt = 0; attempt < 1000; attempt++)
+    {
+        uint32_t before = atomic_ref<uint32_t>(*sequencePtr).load(memory_order_acquire);
+        if (before & 1)
+            continue;
+        memcpy(&out, page, sizeof(MetricsPage));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_ref<uint32_t>(*sequencePtr).load(memory_order_relaxed) == before)
+            return true;
+    }
+    return false;
+}
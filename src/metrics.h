@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "jitter_monitor.h"
+#include "launch_model.h"
+#include "launch_pipeline.h"
+
+// === LIVE METRICS ===
+// A shared-memory page of counters and gauges that the launch loop updates
+// with plain stores under a seqlock. Each rig's control thread owns its own
+// page (see RigPath() for the names), so rigs never share a writer. External
+// tools (hotwheels-stat) map it read-only and never touch the control thread.
+
+constexpr const char *METRICS_SHM_NAME = "/hotwheels_metrics";
+constexpr uint32_t METRICS_MAGIC = 0x4D574848; // "HHWM"
+constexpr uint32_t METRICS_VERSION = 5;
+constexpr uint32_t METRICS_STATS_CAPACITY = 16384; // bytes of serialized LaunchStatistics
+
+enum LaunchPhase
+{
+    PHASE_RAMP_MOVE = 0,
+    PHASE_SENSOR1_WAIT,
+    PHASE_DOOR_OPEN,
+    PHASE_SENSOR2_WAIT,
+    PHASE_DOOR_CLOSE,
+    PHASE_PHYSICS,
+    PHASE_CATCHER_MOVE,
+    PHASE_COUNT
+};
+
+extern const char *const LAUNCH_PHASE_NAMES[PHASE_COUNT];
+
+struct PhaseStats
+{
+    uint64_t count;
+    int64_t lastNs;
+    int64_t maxNs;
+    int64_t totalNs;
+};
+
+struct alignas(64) MetricsPage
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sequence; // odd while the writer is mid-update
+    int32_t pid;
+    int32_t rig;
+    int32_t reserved;
+    int64_t updatedNs; // clock time of the last launch
+
+    uint64_t launches;
+    uint64_t catches; // as told by the catch detector
+    uint64_t misses;
+    uint64_t undetected; // completed launches with no outcome
+    uint64_t sensorTimeouts;
+
+    double axisTarget[AXIS_COUNT];
+    double lastAngle;
+    double lastSpeed;
+    double lastLanding;
+    double lastMargin;
+
+    PhaseStats phases[PHASE_COUNT];
+
+    JitterHistogram loopWakeup; // control-loop wake-up latency
+    JitterHistogram loopExec;   // control-loop execution time
+
+    uint32_t statsBytes; // 0 = none yet or did not fit
+    uint8_t stats[METRICS_STATS_CAPACITY]; // LaunchStatistics::Serialize() blob
+};
+
+// Writer side, called from the launch loop. The page belongs to the thread that
+// opened it; on any other thread these are no-ops, as they are before MetricsOpen().
+bool MetricsOpen(const char *name = METRICS_SHM_NAME, int rig = 0);
+void MetricsClose();
+void MetricsPhase(LaunchPhase phase, int64_t durationNs);
+void MetricsAxisTarget(AxisID axis, double target);
+void MetricsLaunch(double angle, double speed, double landing, double margin);
+void MetricsOutcome(CatchOutcome outcome);
+void MetricsSensorTimeout();
+void MetricsLoopIteration(int64_t wakeupNs, int64_t execNs, bool lateWakeup, bool longExec);
+void MetricsStatistics(const uint8_t *blob, size_t size);
+bool MetricsActive(); // this thread has a page open
+
+// Page name for a rig: rig 0 keeps METRICS_SHM_NAME, rig N adds "_rigN".
+std::string MetricsRigName(int rig);
+
+// Reader side: maps the page read-only and takes consistent snapshots.
+const MetricsPage *MetricsMapReadOnly(const char *name = METRICS_SHM_NAME);
+bool MetricsSnapshot(const MetricsPage *page, MetricsPage &out);
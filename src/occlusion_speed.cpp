@@ -0,0 +1,101 @@
+#include "occlusion_speed.h"
+#include "car_tracker.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+void OcclusionSpeed::Poll(const StatusSnapshot &status, int64_t now)
+{
+    for (int s = 0; s < 2; s++)
+    {
+        bool level = status.sensors[s];
+        if (level && !levels[s])
+        {
+            BeamBreak &last = breaks[s][(next[s] + OCCLUSION_HISTORY - 1) % OCCLUSION_HISTORY];
+            // Re-made this soon, the beam flickered and the car is still in it.
+            if (last.fall != 0 && now - last.fall <= EDGE_BOUNCE_NS)
+                last.fall = 0;
+            else
+                breaks[s][next[s]++ % OCCLUSION_HISTORY] = BeamBreak{now, 0};
+        }
+        else if (!level && levels[s])
+            breaks[s][(next[s] + OCCLUSION_HISTORY - 1) % OCCLUSION_HISTORY].fall = now;
+        levels[s] = level;
+    }
+}
+
+double OcclusionSpeed::Occlusion(int sensor, int64_t edgeNs) const
+{
+    for (const BeamBreak &beamBreak : breaks[sensor - 1])
+    {
+        if (beamBreak.rise != 0 && llabs(beamBreak.rise - edgeNs) <= SENSOR_POLL_PERIOD_NS && beamBreak.fall > beamBreak.rise)
+            return (beamBreak.fall - beamBreak.rise) * 1e-9;
+    }
+    return 0.0;
+}
+
+double OcclusionSpeed::Speed(double occlusion) const
+{
+    if (occlusion < OCCLUSION_MIN || stats.carLength <= 0.0)
+        return 0.0;
+    double speed = stats.carLength / occlusion;
+    return speed <= MAX_PLAUSIBLE_SPEED ? speed : 0.0;
+}
+
+bool OcclusionSpeed::Update(LaunchRecord &record)
+{
+    if (record.t2 == 0.0 || record.speed <= 0.0)
+        return true;
+    double speed = record.speed;
+    if (record.earlySpeed > 0.0)
+    {
+        stats.earlyCommands++;
+        stats.refined += record.earlyKept ? 0 : 1; // sent again at sensor 2
+        stats.leadSum += record.t2 - record.t1 - record.earlyCmd;
+        double error = (record.earlySpeed - speed) / speed;
+        stats.earlyErrorSq += error * error;
+    }
+
+    bool agree = true;
+    int64_t edges[2] = {SecondsToNs(record.t1), SecondsToNs(record.t2)};
+    for (int s = 0; s < 2; s++)
+    {
+        record.occlusion[s] = Occlusion(s + 1, edges[s]);
+        if (record.occlusion[s] <= 0.0)
+            continue;
+        if (Calibrated())
+        {
+            double error = (Speed(record.occlusion[s]) - speed) / speed;
+            stats.checks++;
+            stats.checkErrorSq += error * error;
+            if (fabs(error) > OCCLUSION_SPEED_TOLERANCE)
+            {
+                stats.disagreements++;
+                agree = false;
+                continue;
+            }
+        }
+        else if (record.occlusion[s] < OCCLUSION_MIN)
+            continue;
+        double length = speed * record.occlusion[s];
+        stats.carLength = (stats.samples == 0) ? length : stats.carLength + CAR_LENGTH_GAIN * (length - stats.carLength);
+        stats.samples++;
+    }
+    return agree;
+}
+
+void PrintOcclusionStats(int rig, const OcclusionStats &stats)
+{
+    if (stats.samples == 0)
+        return;
+    printf("[Rig %d] Occlusion speed: car length %.1f mm from %llu occlusions | %llu checks, rms %.1f%%, %llu disagreements",
+           rig, stats.carLength * 1000.0, (unsigned long long)stats.samples, (unsigned long long)stats.checks,
+           stats.checks ? sqrt(stats.checkErrorSq / stats.checks) * 100.0 : 0.0, (unsigned long long)stats.disagreements);
+    if (stats.earlyCommands)
+        printf(" | %llu early catcher commands, %.1f ms before sensor 2 on average, speed rms %.1f%%, %llu corrected",
+               (unsigned long long)stats.earlyCommands, stats.leadSum / stats.earlyCommands * 1000.0,
+               sqrt(stats.earlyErrorSq / stats.earlyCommands) * 100.0, (unsigned long long)stats.refined);
+    printf("\n");
+}
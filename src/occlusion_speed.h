@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include "launch_pipeline.h"
+
+// === OCCLUSION SPEED ===
+// A car blocks a beam for as long as it takes its own length to pass, so
+// once it clears sensor 1 its speed is car length / occlusion time, before it
+// reaches sensor 2. RunLaunch sends the catcher off on that estimate and
+// corrects it from the beam-to-beam speed at sensor 2, moving it again only
+// if the landing point changed by more than EARLY_REFINE_TOLERANCE. The
+// catcher gains the time between sensor 1 clearing and sensor 2 tripping:
+// sensor distance minus car length, over the speed.
+//
+// The car length is calibrated on the rig: after each launch, the
+// beam-to-beam speed times each beam's occlusion is one measurement of it,
+// averaged with exponential weight. Nothing is sent early until
+// CAR_LENGTH_MIN_SAMPLES occlusions have been measured. From then on both
+// beams' occlusion speeds are also a check on the beam-to-beam speed: a
+// disagreement beyond OCCLUSION_SPEED_TOLERANCE (a flickering beam, a
+// slowing car, something else in the beam) is counted, and the measurement
+// is left out of the calibration.
+//
+// Poll() sees every status read of the waits, like the car tracker, and does
+// no allocation or output. Update() runs between launches.
+
+constexpr int OCCLUSION_HISTORY = 4;                // beam breaks kept per sensor
+constexpr double OCCLUSION_MIN = 0.002;             // s, a shorter break is not a car
+constexpr double CAR_LENGTH_GAIN = 0.1;             // weight of each new length measurement
+constexpr int CAR_LENGTH_MIN_SAMPLES = 5;           // occlusions before the length is trusted
+constexpr double OCCLUSION_SPEED_TOLERANCE = 0.1;   // relative to the beam-to-beam speed
+constexpr double EARLY_REFINE_TOLERANCE = 0.002;    // m, closer than this the early move stands
+
+struct OcclusionStats
+{
+    double carLength = 0.0;     // m, calibrated
+    uint64_t samples = 0;       // occlusions the length was calibrated from
+    uint64_t checks = 0;        // occlusion speeds compared with the beam-to-beam speed
+    uint64_t disagreements = 0; // over OCCLUSION_SPEED_TOLERANCE
+    double checkErrorSq = 0.0;  // relative speed error, summed
+    uint64_t earlyCommands = 0;
+    uint64_t refined = 0;       // early moves corrected at sensor 2
+    double leadSum = 0.0;       // s the early command went out before sensor 2, summed
+    double earlyErrorSq = 0.0;  // relative speed error of the early estimate, summed
+};
+
+class OcclusionSpeed
+{
+public:
+    // Every status read of a wait; no allocation, no output.
+    void Poll(const StatusSnapshot &status, int64_t nowNs);
+
+    // How long the beam break that started at `edgeNs` (within a poll
+    // period) lasted: s, 0 = not over yet or not seen.
+    double Occlusion(int sensor, int64_t edgeNs) const;
+
+    bool Calibrated() const { return stats.samples >= static_cast<uint64_t>(CAR_LENGTH_MIN_SAMPLES); }
+    double Speed(double occlusion) const; // m/s, 0 = not a usable occlusion
+
+    // After the launch, once the car has cleared both beams: fills in the
+    // record's occlusions, checks them and calibrates the car length. False
+    // when an occlusion speed disagreed with the beam-to-beam speed.
+    bool Update(LaunchRecord &record);
+
+    const OcclusionStats &Stats() const { return stats; }
+
+private:
+    struct BeamBreak
+    {
+        int64_t rise = 0; // clock ns
+        int64_t fall = 0; // 0 = still blocked
+    };
+
+    BeamBreak breaks[2][OCCLUSION_HISTORY] = {};
+    int next[2] = {};
+    bool levels[2] = {};
+    OcclusionStats stats;
+};
+
+void PrintOcclusionStats(int rig, const OcclusionStats &stats);
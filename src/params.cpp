@@ -0,0 +1,597 @@
+#include "params.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    // Double buffer: the watcher only ever writes the slot that is not active.
+    Params gSlots[2];
+    Params gStartup;                   // as given to ParamsInit(), never reloaded
+    atomic<const Params *> gActive{&gSlots[0]};
+    atomic<uint64_t> gEpoch{1};        // bumped on every publish
+    uint64_t gLastPublishEpoch = 1;    // watcher thread only
+
+    // Epoch each reader saw when it took its snapshot; 0 = not holding one.
+    atomic<uint64_t> gReaderEpoch[PARAMS_MAX_READERS];
+    atomic<bool> gReaderUsed[PARAMS_MAX_READERS];
+
+    thread gWatchThread;
+    atomic<bool> gWatching{false};
+
+    string Trim(const string &text)
+    {
+        size_t first = text.find_first_not_of(" \t\r");
+        if (first == string::npos)
+            return "";
+        size_t last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    double *FindNumber(Params &params, const string &key)
+    {
+        LaunchParams &launch = params.launch;
+        for (int a = 0; a < AXIS_COUNT; a++)
+        {
+            string prefix = string(AXIS_NAMES[a]) + ".";
+            MotionProfile &profile = launch.profiles[a];
+            if (key == prefix + "velocity")
+                return &profile.velocity;
+            if (key == prefix + "acceleration")
+                return &profile.acceleration;
+            if (key == prefix + "deceleration")
+                return &profile.deceleration;
+            if (key == prefix + "jerk_percent")
+                return &profile.jerkPercent;
+        }
+        if (key == "sensor_distance")
+            return &launch.sensorDistance;
+        if (key == "ramp_height")
+            return &launch.rampHeight;
+        if (key == "min_catcher_position")
+            return &launch.minCatcherPosition;
+        if (key == "max_catcher_position")
+            return &launch.maxCatcherPosition;
+        if (key == "angle_offset")
+            return &launch.angleOffset;
+        if (key == "door_open_base")
+            return &launch.doorOpenBase;
+        if (key == "sensor2_timeout")
+            return &launch.sensor2Timeout;
+        if (key == "post_launch_dwell")
+            return &launch.postLaunchDwell;
+        if (key == "wakeup_budget_us")
+            return &launch.wakeupBudgetUs;
+        if (key == "exec_budget_us")
+            return &launch.execBudgetUs;
+        if (key == "catch_error_threshold")
+            return &launch.catchErrorThreshold;
+        if (key == "catch_output_threshold")
+            return &launch.catchOutputThreshold;
+        return nullptr;
+    }
+
+    bool ParseNumber(const string &text, double &number)
+    {
+        char *end = nullptr;
+        errno = 0;
+        number = strtod(text.c_str(), &end);
+        return !text.empty() && *end == '\0' && errno == 0;
+    }
+
+    // Comma-separated numbers, e.g. "3, 4, 5".
+    bool ParseList(const string &text, vector<double> &numbers)
+    {
+        numbers.clear();
+        size_t start = 0;
+        while (start <= text.size())
+        {
+            size_t comma = text.find(',', start);
+            if (comma == string::npos)
+                comma = text.size();
+            double number;
+            if (!ParseNumber(Trim(text.substr(start, comma - start)), number))
+                return false;
+            numbers.push_back(number);
+            start = comma + 1;
+        }
+        return true;
+    }
+
+    // rigN.axes / .sensor_node / .sensor_inputs / .cpu / .angles
+    bool SetRigKey(Params &params, const string &key, const string &value, string &error)
+    {
+        size_t dot = key.find('.');
+        int rig = atoi(key.c_str() + 3);
+        if (dot == string::npos || rig < 0 || rig >= MAX_RIGS || key.substr(3, dot - 3) != to_string(rig))
+        {
+            error = "'" + key + "' is not a rig key (rig0..rig" + to_string(MAX_RIGS - 1) + ")";
+            return false;
+        }
+        string field = key.substr(dot + 1);
+        RigConfig &config = params.rigs[rig];
+        vector<double> numbers;
+        if (!ParseList(value, numbers))
+        {
+            error = "'" + value + "' is not a number list";
+            return false;
+        }
+        size_t expected = (field == "axes") ? AXIS_COUNT : (field == "sensor_inputs") ? 2 : (field == "angles") ? numbers.size() : 1;
+        if (numbers.size() != expected)
+        {
+            error = key + " expects " + to_string(expected) + " value(s)";
+            return false;
+        }
+        if (field == "axes")
+            copy(numbers.begin(), numbers.end(), config.axisNumbers);
+        else if (field == "sensor_inputs")
+            copy(numbers.begin(), numbers.end(), config.sensorInputs);
+        else if (field == "sensor_node")
+            config.sensorNode = static_cast<int>(numbers[0]);
+        else if (field == "cpu")
+            config.cpu = static_cast<int>(numbers[0]);
+        else if (field == "angles")
+            config.angles = numbers;
+        else
+        {
+            error = "unknown key '" + key + "'";
+            return false;
+        }
+        return true;
+    }
+
+    bool InRange(double value, double low, double high)
+    {
+        return isfinite(value) && value >= low && value <= high;
+    }
+
+    // Blocks until no reader can still be holding the inactive slot.
+    void WaitForReaders()
+    {
+        while (gWatching)
+        {
+            bool clear = true;
+            for (int i = 0; i < PARAMS_MAX_READERS; i++)
+            {
+                uint64_t epoch = gReaderEpoch[i].load();
+                if (epoch != 0 && epoch < gLastPublishEpoch)
+                    clear = false;
+            }
+            if (clear)
+                return;
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    }
+
+    void Publish(const Params &next)
+    {
+        WaitForReaders();
+        if (!gWatching)
+            return;
+        const Params *active = gActive.load();
+        Params *slot = (active == &gSlots[0]) ? &gSlots[1] : &gSlots[0];
+        *slot = next;
+        gActive.store(slot);
+        gLastPublishEpoch = gEpoch.fetch_add(1) + 1;
+    }
+
+    void Reload(const string &path)
+    {
+        Params next; // start from defaults so deleted keys revert
+        string error;
+        if (!ParamsLoadFile(path, next, error))
+        {
+            cerr << "[Params] Rejected " << path << ": " << error << " (keeping current values)\n";
+            return;
+        }
+        const Params &current = *gActive.load();
+        if (next.nicPrimary != current.nicPrimary || next.cpuAffinity != current.cpuAffinity ||
+            next.rt != current.rt || next.rigCount != current.rigCount || next.rigs != current.rigs)
+            cout << "[Params] nic_primary/cpu_affinity/rt_*/rig changes take effect on the next start.\n";
+        next.nicPrimary = current.nicPrimary;
+        next.cpuAffinity = current.cpuAffinity;
+        next.rt = current.rt;
+        next.rigCount = current.rigCount;
+        next.rigs = current.rigs;
+        Publish(next);
+        cout << "[Params] Reloaded " << path << ", applies from the next launch.\n";
+    }
+
+    bool ValidateRigs(const Params &params, string &error)
+    {
+        vector<int> axesInUse;
+        for (int r = 0; r < params.rigCount; r++)
+        {
+            const RigConfig &rig = params.rigs[r];
+            string prefix = "rig" + to_string(r) + ".";
+            for (int a = 0; a < AXIS_COUNT; a++)
+            {
+                if (rig.axisNumbers[a] < 0 || find(axesInUse.begin(), axesInUse.end(), rig.axisNumbers[a]) != axesInUse.end())
+                {
+                    error = prefix + "axes must be distinct axis numbers not used by another rig";
+                    return false;
+                }
+                axesInUse.push_back(rig.axisNumbers[a]);
+            }
+            if (rig.sensorNode < 0 || rig.sensorInputs[0] < 0 || rig.sensorInputs[1] < 0 ||
+                rig.sensorInputs[0] == rig.sensorInputs[1])
+                error = prefix + "sensor_node/sensor_inputs must be non-negative, with two different inputs";
+            else if (rig.cpu < -1 || rig.cpu >= 1024)
+                error = prefix + "cpu must be -1 or a CPU index";
+            else if (rig.cpu >= 0 && rig.cpu == params.cpuAffinity)
+                error = prefix + "cpu must not be the RMP core (cpu_affinity)";
+            else if (params.rigCount > 1 && rig.angles.empty())
+                error = prefix + "angles is required when running more than one rig";
+            else if (any_of(rig.angles.begin(), rig.angles.end(), [](double angle) { return !InRange(angle, 0.0, 90.0); }))
+                error = prefix + "angles must be within 0..90 deg";
+            else
+                continue;
+            return false;
+        }
+        return true;
+    }
+
+    void WatchLoop(string path, int fd)
+    {
+        size_t slash = path.find_last_of('/');
+        string fileName = (slash == string::npos) ? path : path.substr(slash + 1);
+        alignas(inotify_event) char buffer[4096];
+
+        while (gWatching)
+        {
+            pollfd pfd = {fd, POLLIN, 0};
+            if (poll(&pfd, 1, 250) <= 0)
+                continue;
+            ssize_t length = read(fd, buffer, sizeof(buffer));
+            bool changed = false;
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const inotify_event *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                if (event->len && fileName == event->name)
+                    changed = true;
+                offset += sizeof(inotify_event) + event->len;
+            }
+            if (changed)
+                Reload(path);
+        }
+        close(fd);
+    }
+}
+
+array<RigConfig, MAX_RIGS> Params::DefaultRigConfigs()
+{
+    array<RigConfig, MAX_RIGS> rigs;
+    for (int r = 0; r < MAX_RIGS; r++)
+        rigs[r] = DefaultRigConfig(r);
+    return rigs;
+}
+
+// === LOADING ===
+bool ParamsLoadFile(const string &path, Params &out, string &error)
+{
+    ifstream file(path);
+    if (!file)
+    {
+        error = "cannot open file";
+        return false;
+    }
+
+    Params next = out;
+    string line;
+    int lineNumber = 0;
+    while (getline(file, line))
+    {
+        lineNumber++;
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty())
+            continue;
+        size_t equals = line.find('=');
+        if (equals == string::npos)
+        {
+            error = "line " + to_string(lineNumber) + ": expected key = value";
+            return false;
+        }
+        string key = Trim(line.substr(0, equals));
+        string value = Trim(line.substr(equals + 1));
+
+        if (key == "nic_primary")
+        {
+            next.nicPrimary = value;
+            continue;
+        }
+        if (key == "rt_policy")
+        {
+            next.rt.policy = value;
+            continue;
+        }
+        if (key.compare(0, 3, "rig") == 0 && key != "rig_count")
+        {
+            if (!SetRigKey(next, key, value, error))
+            {
+                error = "line " + to_string(lineNumber) + ": " + error;
+                return false;
+            }
+            continue;
+        }
+        double number;
+        if (!ParseNumber(value, number))
+        {
+            error = "line " + to_string(lineNumber) + ": '" + value + "' is not a number";
+            return false;
+        }
+        if (key == "cpu_affinity")
+        {
+            next.cpuAffinity = static_cast<int>(number);
+            continue;
+        }
+        if (key == "rig_count")
+        {
+            next.rigCount = static_cast<int>(number);
+            continue;
+        }
+        if (key == "rt_priority")
+        {
+            next.rt.priority = static_cast<int>(number);
+            continue;
+        }
+        if (key == "jitter_snapshot")
+        {
+            next.launch.jitterSnapshot = number != 0.0;
+            continue;
+        }
+        if (key == "pipeline_cars")
+        {
+            next.launch.pipelineCars = number != 0.0;
+            continue;
+        }
+        if (key == "landing_correction")
+        {
+            next.launch.landingCorrection = number != 0.0;
+            continue;
+        }
+        if (key == "early_catcher")
+        {
+            next.launch.earlyCatcher = number != 0.0;
+            continue;
+        }
+        if (key == "rt_lock_memory")
+        {
+            next.rt.lockMemory = number != 0.0;
+            continue;
+        }
+        if (key == "rt_prefault_stack_kb")
+        {
+            next.rt.prefaultStackKb = number > 0.0 ? static_cast<size_t>(number) : 0;
+            continue;
+        }
+        if (key == "rt_prefault_heap_kb")
+        {
+            next.rt.prefaultHeapKb = number > 0.0 ? static_cast<size_t>(number) : 0;
+            continue;
+        }
+        double *field = FindNumber(next, key);
+        if (!field)
+        {
+            error = "line " + to_string(lineNumber) + ": unknown key '" + key + "'";
+            return false;
+        }
+        *field = number;
+    }
+
+    if (!ParamsValidate(next, error))
+        return false;
+    out = next;
+    return true;
+}
+
+bool ParamsValidate(const Params &params, string &error)
+{
+    const LaunchParams &launch = params.launch;
+    for (int a = 0; a < AXIS_COUNT; a++)
+    {
+        const MotionProfile &profile = launch.profiles[a];
+        if (!InRange(profile.velocity, 1e-6, 1e7) || !InRange(profile.acceleration, 1e-6, 1e8) ||
+            !InRange(profile.deceleration, 1e-6, 1e8))
+        {
+            error = string(AXIS_NAMES[a]) + ": velocity/acceleration/deceleration must be positive";
+            return false;
+        }
+        if (!InRange(profile.jerkPercent, 0.0, 100.0))
+        {
+            error = string(AXIS_NAMES[a]) + ": jerk_percent must be within 0..100";
+            return false;
+        }
+    }
+    if (!InRange(launch.sensorDistance, 1e-3, 1.0))
+        error = "sensor_distance must be within 0.001..1 m";
+    else if (!InRange(launch.rampHeight, 0.0, 2.0))
+        error = "ramp_height must be within 0..2 m";
+    else if (!InRange(launch.minCatcherPosition, 0.0, 2.0) || !InRange(launch.maxCatcherPosition, 0.0, 2.0) ||
+             launch.minCatcherPosition >= launch.maxCatcherPosition)
+        error = "catcher range must satisfy 0 <= min < max <= 2 m";
+    else if (!InRange(launch.angleOffset, -10.0, 10.0))
+        error = "angle_offset must be within -10..10 deg";
+    else if (!InRange(launch.doorOpenBase, 1.0, 180.0))
+        error = "door_open_base must be within 1..180 deg";
+    else if (!InRange(launch.sensor2Timeout, 0.01, 30.0))
+        error = "sensor2_timeout must be within 0.01..30 s";
+    else if (!InRange(launch.postLaunchDwell, 0.0, 60.0))
+        error = "post_launch_dwell must be within 0..60 s";
+    else if (!InRange(launch.wakeupBudgetUs, 1.0, 1e6) || !InRange(launch.execBudgetUs, 1.0, 1e6))
+        error = "wakeup_budget_us/exec_budget_us must be within 1..1000000 us";
+    else if (!InRange(launch.catchErrorThreshold, 1e-6, 0.1))
+        error = "catch_error_threshold must be within 0.000001..0.1 m";
+    else if (!InRange(launch.catchOutputThreshold, 0.0, 100.0))
+        error = "catch_output_threshold must be within 0..100 %";
+    else if (params.nicPrimary.empty())
+        error = "nic_primary must not be empty";
+    else if (params.cpuAffinity < -1 || params.cpuAffinity >= 1024)
+        error = "cpu_affinity must be -1 or a CPU index";
+    else if (!RtPolicyValid(params.rt.policy))
+        error = "rt_policy must be other, fifo or rr";
+    else if (params.rt.policy != "other" && (params.rt.priority < 1 || params.rt.priority > 99))
+        error = "rt_priority must be within 1..99";
+    else if (params.rt.prefaultStackKb > 8192 || params.rt.prefaultHeapKb > 1024 * 1024)
+        error = "rt_prefault_stack_kb must be <= 8192 and rt_prefault_heap_kb <= 1048576";
+    else if (params.rigCount < 1 || params.rigCount > MAX_RIGS)
+        error = "rig_count must be within 1.." + to_string(MAX_RIGS);
+    else
+        return ValidateRigs(params, error);
+    return false;
+}
+
+// === WRITING ===
+bool ParamsWriteProfile(const string &path, AxisID axis, const MotionProfile &profile, string &error)
+{
+    string prefix = string(AXIS_NAMES[axis]) + ".";
+    pair<string, double> values[] = {{prefix + "acceleration", profile.acceleration},
+                                     {prefix + "deceleration", profile.deceleration},
+                                     {prefix + "jerk_percent", profile.jerkPercent}};
+    bool written[3] = {};
+    auto format = [](const string &key, double value) {
+        char text[128];
+        snprintf(text, sizeof(text), "%s = %.6g", key.c_str(), value);
+        return string(text);
+    };
+
+    vector<string> lines;
+    ifstream in(path);
+    string line;
+    while (getline(in, line))
+    {
+        size_t comment = line.find('#');
+        string body = line.substr(0, comment);
+        size_t equals = body.find('=');
+        if (equals != string::npos)
+        {
+            string key = Trim(body.substr(0, equals));
+            for (int v = 0; v < 3; v++)
+            {
+                if (key != values[v].first)
+                    continue;
+                // Keep a trailing comment, aligned where it was.
+                string replaced = format(key, values[v].second);
+                if (comment != string::npos)
+                {
+                    size_t padding = (comment > replaced.size()) ? comment - replaced.size() : 1;
+                    replaced += string(padding, ' ') + line.substr(comment);
+                }
+                line = replaced;
+                written[v] = true;
+            }
+        }
+        lines.push_back(line);
+    }
+    for (int v = 0; v < 3; v++)
+    {
+        if (!written[v])
+            lines.push_back(format(values[v].first, values[v].second));
+    }
+
+    string temporary = path + ".tmp";
+    {
+        ofstream out(temporary, ios::trunc);
+        for (const string &text : lines)
+            out << text << "\n";
+        if (!out)
+        {
+            error = "cannot write " + temporary;
+            return false;
+        }
+    }
+    if (rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        error = string("rename failed: ") + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+// === SNAPSHOTS ===
+void ParamsInit(const Params &initial)
+{
+    gSlots[0] = initial;
+    gStartup = initial;
+    gActive.store(&gSlots[0]);
+}
+
+const Params &ParamsStartup()
+{
+    return gStartup;
+}
+
+int ParamsRegisterReader()
+{
+    for (int reader = 0; reader < PARAMS_MAX_READERS; reader++)
+    {
+        bool expected = false;
+        if (gReaderUsed[reader].compare_exchange_strong(expected, true))
+            return reader;
+    }
+    cerr << "[Params] Too many parameter readers.\n";
+    abort();
+}
+
+void ParamsUnregisterReader(int reader)
+{
+    gReaderEpoch[reader].store(0);
+    gReaderUsed[reader].store(false);
+}
+
+const Params &ParamsAcquire(int reader)
+{
+    gReaderEpoch[reader].store(gEpoch.load());
+    return *gActive.load();
+}
+
+void ParamsRelease(int reader)
+{
+    gReaderEpoch[reader].store(0, memory_order_release);
+}
+
+// === WATCHER ===
+bool ParamsWatchStart(const string &path)
+{
+    if (gWatching)
+        return true;
+    int fd = inotify_init1(IN_CLOEXEC);
+    if (fd < 0)
+    {
+        cerr << "[Params] inotify_init failed: " << strerror(errno) << endl;
+        return false;
+    }
+    // Watch the directory: editors usually replace the file rather than write it in place.
+    size_t slash = path.find_last_of('/');
+    string directory = (slash == string::npos) ? "." : path.substr(0, slash);
+    if (inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        cerr << "[Params] Cannot watch " << directory << ": " << strerror(errno) << endl;
+        close(fd);
+        return false;
+    }
+    gWatching = true;
+    gWatchThread = thread(WatchLoop, path, fd);
+    cout << "[Params] Watching " << path << " for changes.\n";
+    return true;
+}
+
+void ParamsWatchStop()
+{
+    if (!gWatching)
+        return;
+    gWatching = false;
+    if (gWatchThread.joinable())
+        gWatchThread.join();
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <array>
+#include <string>
+#include "launch_model.h"
+#include "rig.h"
+#include "rt_setup.h"
+
+// === RUNTIME PARAMETERS ===
+// Tuning parameters loaded from a `key = value` file and watched with inotify.
+// A reload is parsed and validated on the watcher thread, written into the
+// inactive half of a double buffer and published with a single pointer swap.
+// Control threads take a snapshot at the start of each launch and release it
+// at the end, so a change lands between launches and readers never lock; the
+// watcher only reuses a buffer once every reader has released the old one.
+
+constexpr int PARAMS_MAX_READERS = 16;
+
+struct Params
+{
+    LaunchParams launch;
+
+    // Startup-only: changes are accepted but take effect on the next start.
+    std::string nicPrimary = "enp6s0";
+    int cpuAffinity = 3;
+    RtConfig rt;
+    int rigCount = 1;
+    std::array<RigConfig, MAX_RIGS> rigs = DefaultRigConfigs();
+
+    static std::array<RigConfig, MAX_RIGS> DefaultRigConfigs();
+};
+
+// Parses and validates a parameter file on top of `out` (keys not in the file
+// keep their current value). On failure `out` is untouched and `error` says why.
+bool ParamsLoadFile(const std::string &path, Params &out, std::string &error);
+bool ParamsValidate(const Params &params, std::string &error);
+
+// Rewrites one axis's acceleration, deceleration and jerk_percent in a
+// parameter file, keeping every other line and comment; keys the file lacks are
+// appended. The file is replaced atomically, so a watching demo reloads it once.
+bool ParamsWriteProfile(const std::string &path, AxisID axis, const MotionProfile &profile, std::string &error);
+
+// Sets the initial snapshot. Call before any reader or the watcher starts.
+void ParamsInit(const Params &initial);
+
+// The parameters ParamsInit() was given. A separate copy that reloads never
+// touch, so any thread may read it at any time; launch parameters that should
+// follow reloads come from ParamsAcquire() instead.
+const Params &ParamsStartup();
+
+// Control-thread side. Each control thread registers once and unregisters when
+// it stops, freeing the slot for the next one.
+int ParamsRegisterReader();
+void ParamsUnregisterReader(int reader);
+const Params &ParamsAcquire(int reader);
+void ParamsRelease(int reader);
+
+bool ParamsWatchStart(const std::string &path);
+void ParamsWatchStop();
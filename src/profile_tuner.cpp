@@ -0,0 +1,185 @@
+#include "profile_tuner.h"
+#include "params.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+
+namespace
+{
+    struct MoveResult
+    {
+        double settleTime = 0.0;
+        double peakError = 0.0;
+        bool settled = false;
+        bool tripped = false; // the axis faulted, e.g. on its error limit
+    };
+
+    // Commands one move and polls the status snapshot every control period
+    // until motion is done, keeping the largest following error seen.
+    MoveResult MeasureMove(LaunchIO &io, AxisID axis, double target, const MotionProfile &profile)
+    {
+        MoveResult result;
+        Clock &clock = GetClock();
+        int64_t start = clock.NowNs();
+        if (io.MoveAxis(axis, target, profile) != IO_OK)
+            return result;
+        int64_t deadline = start + SecondsToNs(TUNE_SETTLE_TIMEOUT);
+        int64_t next = start;
+        while (!io.Aborted() && clock.NowNs() < deadline)
+        {
+            StatusSnapshot status;
+            if (io.ReadStatus(status) == IO_OK)
+            {
+                result.peakError = max(result.peakError, fabs(status.followingError[axis]));
+                if (status.motionDone[axis] || status.fault[axis])
+                {
+                    result.settled = status.motionDone[axis] && !status.fault[axis];
+                    result.tripped = status.fault[axis];
+                    break;
+                }
+            }
+            next += SENSOR_POLL_PERIOD_NS;
+            clock.SleepUntil(next);
+        }
+        result.settleTime = (clock.NowNs() - start) * 1e-9;
+        return result;
+    }
+}
+
+// === SWEEP ===
+vector<ProfileTrial> SweepProfile(LaunchIO &io, AxisID axis, const MotionProfile &base)
+{
+    vector<ProfileTrial> trials;
+    io.MoveAxis(axis, TUNE_MOVE_FROM[axis], base);
+    io.WaitMotionDone(axis, TUNE_SETTLE_TIMEOUT);
+
+    for (double scale : TUNE_ACCEL_SCALES)
+    {
+        for (double jerk : TUNE_JERK_PERCENTS)
+        {
+            if (io.Aborted())
+                return trials;
+            ProfileTrial trial;
+            trial.profile = base;
+            trial.profile.acceleration = base.acceleration * scale;
+            trial.profile.deceleration = base.deceleration * scale;
+            trial.profile.jerkPercent = jerk;
+
+            MoveResult out = MeasureMove(io, axis, TUNE_MOVE_TO[axis], trial.profile);
+            MoveResult back = MeasureMove(io, axis, TUNE_MOVE_FROM[axis], trial.profile);
+            trial.settled = out.settled && back.settled;
+            trial.tripped = out.tripped || back.tripped;
+            trial.settleTime = max(out.settleTime, back.settleTime);
+            trial.peakError = max(out.peakError, back.peakError);
+            trials.push_back(trial);
+
+            // An unsettled trial may have left the axis anywhere, or faulted;
+            // start the next one from rest.
+            if (!trial.settled)
+            {
+                if (trial.tripped &&
+                    (io.ClearAxisFault(axis) != IO_OK || io.EnableAxis(axis) != IO_OK || io.ReferenceAxis(axis) != IO_OK))
+                {
+                    cerr << "[Tune] " << AXIS_NAMES[axis] << ": could not clear the fault (" << io.ErrorDetail() << ")\n";
+                    return trials;
+                }
+                io.MoveAxis(axis, TUNE_MOVE_FROM[axis], base);
+                io.WaitMotionDone(axis, TUNE_SETTLE_TIMEOUT);
+            }
+        }
+    }
+    return trials;
+}
+
+int PickProfile(vector<ProfileTrial> &trials, AxisID axis)
+{
+    for (ProfileTrial &trial : trials)
+    {
+        trial.pareto = trial.settled;
+        for (const ProfileTrial &other : trials)
+        {
+            if (!trial.pareto)
+                break;
+            bool noWorse = other.settleTime <= trial.settleTime && other.peakError <= trial.peakError;
+            bool better = other.settleTime < trial.settleTime || other.peakError < trial.peakError;
+            if (other.settled && noWorse && better)
+                trial.pareto = false;
+        }
+    }
+
+    // Fastest within budget; if nothing is, the smallest error on the front.
+    int fastest = -1, smallest = -1;
+    for (int i = 0; i < static_cast<int>(trials.size()); i++)
+    {
+        const ProfileTrial &trial = trials[i];
+        if (!trial.pareto)
+            continue;
+        if (trial.peakError <= TUNE_ERROR_BUDGET[axis] && (fastest < 0 || trial.settleTime < trials[fastest].settleTime))
+            fastest = i;
+        if (smallest < 0 || trial.peakError < trials[smallest].peakError)
+            smallest = i;
+    }
+    return fastest >= 0 ? fastest : smallest;
+}
+
+void PrintTrials(const vector<ProfileTrial> &trials, AxisID axis, int pick)
+{
+    printf("[Tune] %s: %g -> %g and back, error budget %g\n", AXIS_NAMES[axis], TUNE_MOVE_FROM[axis], TUNE_MOVE_TO[axis],
+           TUNE_ERROR_BUDGET[axis]);
+    printf("%14s %14s %7s %11s %12s %s\n", "acceleration", "deceleration", "jerk%", "settle_ms", "peak_error", "");
+    for (int i = 0; i < static_cast<int>(trials.size()); i++)
+    {
+        const ProfileTrial &trial = trials[i];
+        const char *mark = (i == pick)     ? "<- pick"
+                         : trial.pareto    ? "pareto"
+                         : trial.settled   ? ""
+                         : trial.tripped   ? "tripped"
+                                           : "unsettled";
+        printf("%14g %14g %7g %11.1f %12.5g %s\n", trial.profile.acceleration, trial.profile.deceleration,
+               trial.profile.jerkPercent, trial.settleTime * 1000.0, trial.peakError, mark);
+    }
+}
+
+// === DRIVER ===
+int RunProfileTuning(LaunchIO &io, int axis, const char *applyPath)
+{
+    // A copy from a reader snapshot: with applyPath set, the sweep's own
+    // writes reload the parameters while it runs.
+    int paramsReader = ParamsRegisterReader();
+    LaunchParams current = ParamsAcquire(paramsReader).launch;
+    ParamsRelease(paramsReader);
+    ParamsUnregisterReader(paramsReader);
+    int result = 0;
+    for (int a = 0; a < AXIS_COUNT; a++)
+    {
+        if (axis >= 0 && a != axis)
+            continue;
+        AxisID id = static_cast<AxisID>(a);
+        vector<ProfileTrial> trials = SweepProfile(io, id, current.profiles[a]);
+        int pick = PickProfile(trials, id);
+        PrintTrials(trials, id, pick);
+        if (pick < 0)
+        {
+            cerr << "[Tune] " << AXIS_NAMES[a] << ": no trial settled, keeping the current profile.\n";
+            result = 1;
+            continue;
+        }
+        const MotionProfile &chosen = trials[pick].profile;
+        printf("%s.acceleration = %g\n%s.deceleration = %g\n%s.jerk_percent = %g\n\n", AXIS_NAMES[a], chosen.acceleration,
+               AXIS_NAMES[a], chosen.deceleration, AXIS_NAMES[a], chosen.jerkPercent);
+        if (!applyPath)
+            continue;
+        string error;
+        if (ParamsWriteProfile(applyPath, id, chosen, error))
+            cout << "[Tune] " << AXIS_NAMES[a] << " profile written to " << applyPath << "\n";
+        else
+        {
+            cerr << "[Tune] Could not update " << applyPath << ": " << error << "\n";
+            result = 1;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "launch_pipeline.h"
+
+// === PROFILE TUNER ===
+// Sweeps acceleration (deceleration scaled with it) and jerk for one axis over a
+// representative move, out and back. Each trial polls ReadStatus() every
+// control period and records how long the axis took from the command to
+// motion done (move plus settle) and its peak following error. The trials
+// that no other trial beats on both counts form the Pareto front; the pick is
+// the fastest of those within the axis's error budget. Runs against the live
+// rig or the simulated servo model through the same LaunchIO.
+
+constexpr double TUNE_ACCEL_SCALES[] = {0.25, 0.5, 1.0, 2.0, 4.0}; // x the current acceleration
+constexpr double TUNE_JERK_PERCENTS[] = {0.0, 25.0, 50.0, 75.0, 100.0};
+constexpr double TUNE_SETTLE_TIMEOUT = 5.0; // s per move before a trial counts as unsettled
+
+// Sweep move per axis (ramp and door in deg, catcher in m) and the peak
+// following error a pick may have.
+constexpr double TUNE_MOVE_FROM[AXIS_COUNT] = {20.0, 0.0, 0.1};
+constexpr double TUNE_MOVE_TO[AXIS_COUNT] = {45.0, 70.0, 0.7};
+constexpr double TUNE_ERROR_BUDGET[AXIS_COUNT] = {0.5, 2.0, 0.005};
+
+struct ProfileTrial
+{
+    MotionProfile profile;
+    double settleTime = 0.0; // s, worst of the two directions
+    double peakError = 0.0;  // axis units, largest |following error| seen
+    bool settled = false;
+    bool tripped = false;    // faulted during the trial; the sweep clears it before the next
+    bool pareto = false;
+};
+
+// Runs the sweep on `axis`, starting from `base` (the velocity is kept), and
+// leaves the axis at TUNE_MOVE_FROM.
+std::vector<ProfileTrial> SweepProfile(LaunchIO &io, AxisID axis, const MotionProfile &base);
+
+// Flags the Pareto-optimal trials and returns the index of the pick, -1 if
+// nothing settled.
+int PickProfile(std::vector<ProfileTrial> &trials, AxisID axis);
+
+void PrintTrials(const std::vector<ProfileTrial> &trials, AxisID axis, int pick);
+
+// Sweeps `axis` (or all axes for -1) starting from the current parameters,
+// prints each table and the pick and, with `applyPath`, writes the picks into
+// that parameter file, which a running demo then reloads.
+int RunProfileTuning(LaunchIO &io, int axis, const char *applyPath);
@@ -0,0 +1,146 @@
+#include "replay.h"
+#include "launch_log.h"
+#include "launch_pipeline.h"
+#include "clock.h"
+#include "params.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    // Plays one recorded launch back: sensor edges arrive at their recorded
+    // times and each axis command takes as long as it took on the rig.
+    class ReplayIO : public LaunchIO
+    {
+    public:
+        explicit ReplayIO(const LaunchRecord &original) : original(original)
+        {
+            verbose = false;
+        }
+
+        IoResult<bool> SensorLevel(int sensor) override
+        {
+            return {Now() >= ((sensor == 1) ? original.t1 : original.t2)};
+        }
+
+        // Jumps straight to the recorded edge instead of polling for it.
+        int64_t WaitSensor(int sensor, double) override
+        {
+            double edge = (sensor == 1) ? original.t1 : original.t2;
+            if (edge == 0.0)
+                return 0;
+            GetClock().SleepUntil(SecondsToNs(edge));
+            return SecondsToNs(edge);
+        }
+
+        IoError MoveAxis(AxisID axis, double pos, const MotionProfile &) override
+        {
+            Clock &clock = GetClock();
+            if (axis == CATCHER)
+            {
+                clock.SleepFor(SecondsToNs(original.catcherLatency));
+                catcherPosition = pos;
+            }
+            else if (axis == DOOR)
+            {
+                clock.SleepFor(SecondsToNs((pos != 0.0) ? original.doorOpenLatency : original.doorCloseLatency));
+            }
+            return IO_OK;
+        }
+
+        IoResult<double> AxisActualPosition(AxisID axis) override
+        {
+            if (axis == CATCHER)
+                return {catcherPosition};
+            if (axis == RAMP)
+                return {original.rampActual};
+            return {0.0};
+        }
+
+        IoResult<bool> MotionDone(AxisID) override { return {true}; }
+
+        // The learned correction is not replayed, only re-applied as recorded.
+        double LandingCorrectionAt(double speed, double) override
+        {
+            if (original.earlySpeed > 0.0 && speed == original.earlySpeed)
+                return original.earlyCorrection;
+            return original.landingCorrection;
+        }
+
+        // The early catcher command goes out when it did, on the speed it was sent on.
+        double WaitEarlySpeed(int64_t, double) override
+        {
+            if (original.earlySpeed <= 0.0)
+                return 0.0;
+            GetClock().SleepUntil(SecondsToNs(original.t1 + original.earlyCmd));
+            return original.earlySpeed;
+        }
+
+    private:
+        const LaunchRecord &original;
+        double catcherPosition = original.catcherStart;
+    };
+}
+
+int RunReplay(const string &logPath)
+{
+    vector<LaunchRecord> originals;
+    if (!LaunchLogRead(logPath, originals))
+    {
+        cerr << "[Replay] Could not read " << logPath << endl;
+        return 1;
+    }
+    cout << "[Replay] " << originals.size() << " launches from " << logPath << "\n";
+
+    Clock &previousClock = GetClock();
+    VirtualClock clock;
+    SetClock(clock);
+
+    auto start = chrono::steady_clock::now();
+    int feasibilityChanges = 0, incomplete = 0;
+    double sumLandingDiff = 0.0, maxLandingDiff = 0.0;
+
+    printf("%8s %7s %9s %9s %9s %10s %10s %9s\n",
+           "launch", "angle", "landing", "replayed", "d_land", "cmd_ms", "d_cmd_ms", "feasible");
+    for (const LaunchRecord &original : originals)
+    {
+        // Launches may come from different runs, so each starts the clock at its own sensor 1 edge.
+        clock.Reset(SecondsToNs(original.t1));
+        ReplayIO io(original);
+        LaunchRecord replayed;
+        replayed.launchId = original.launchId;
+        if (!RunLaunch(io, original.angle, replayed, ParamsStartup().launch))
+        {
+            incomplete++;
+            continue;
+        }
+
+        double landingDiff = replayed.landing - original.landing;
+        double commandDiff = replayed.catcherCmd - original.catcherCmd;
+        sumLandingDiff += fabs(landingDiff);
+        maxLandingDiff = max(maxLandingDiff, fabs(landingDiff));
+        if (replayed.feasible != original.feasible)
+            feasibilityChanges++;
+
+        printf("%8u %7.2f %9.4f %9.4f %+9.4f %10.3f %+10.3f %4s->%-4s\n",
+               original.launchId, original.angle, original.landing, replayed.landing, landingDiff,
+               replayed.catcherCmd * 1000.0, commandDiff * 1000.0,
+               original.feasible ? "yes" : "no", replayed.feasible ? "yes" : "no");
+    }
+
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    size_t compared = originals.size() - incomplete;
+    cout << "[Replay] Compared " << compared << " launches in " << elapsed * 1000.0 << " ms"
+         << " | mean |d_land|: " << (compared ? sumLandingDiff / compared : 0.0) << " m"
+         << " | max |d_land|: " << maxLandingDiff << " m"
+         << " | feasibility changes: " << feasibilityChanges << "\n";
+    if (incomplete)
+        cout << "[Replay] " << incomplete << " launches had no sensor edges and were skipped.\n";
+    SetClock(previousClock);
+    return 0;
+}
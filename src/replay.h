@@ -0,0 +1,9 @@
+#pragma once
+#include <string>
+
+// === REPLAY ===
+// Re-runs recorded launches through the current launch pipeline under a virtual
+// clock, with the landing correction each one was planned with, and prints
+// how predicted landing, catcher command timing and feasibility differ from
+// the original run. Returns a process exit code.
+int RunReplay(const std::string &logPath);
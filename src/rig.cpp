@@ -0,0 +1,291 @@
+#include "rig.h"
+#include "angle_recommender.h"
+#include "launch_history.h"
+#include "launch_log.h"
+#include "metrics.h"
+#include "params.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <pthread.h>
+#include <sched.h>
+
+using namespace std;
+
+namespace
+{
+    double ThreadCpuSeconds()
+    {
+        timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return now.tv_sec + now.tv_nsec * 1e-9;
+    }
+}
+
+RigConfig DefaultRigConfig(int rig)
+{
+    RigConfig config;
+    for (int a = 0; a < AXIS_COUNT; a++)
+        config.axisNumbers[a] = rig * AXIS_COUNT + a;
+    config.sensorNode = rig * AXIS_COUNT + 1;
+    return config;
+}
+
+AngleSource CycleAngles(vector<double> angles, uint64_t launches)
+{
+    uint64_t next = 0;
+    return [angles = move(angles), launches, next](double &angle) mutable {
+        if (angles.empty() || (launches != 0 && next >= launches))
+            return false;
+        angle = angles[next++ % angles.size()];
+        return true;
+    };
+}
+
+// === CONTROL LOOP ===
+void RunRig(LaunchIO &io, const AngleSource &nextAngle, RigStats &stats, LaunchLogWriter *log, HistoryWriter *history,
+            AngleRecommender *recommender)
+{
+    int paramsReader = ParamsRegisterReader();
+    Clock &clock = GetClock();
+    double clockStart = clock.NowSeconds();
+    auto wallStart = chrono::steady_clock::now();
+    double cpuStart = ThreadCpuSeconds();
+    vector<uint8_t> statsBlob; // reused for every publish
+    CarTracker tracker;
+    LandingCorrection correction;
+    OcclusionSpeed occlusion;
+    io.occlusion = &occlusion;
+
+    // Once a completed launch's catcher has settled and the car has landed.
+    auto finish = [&](LaunchRecord &record) {
+        stats.caught += record.outcome == CATCH_CAUGHT ? 1 : 0;
+        stats.missed += record.outcome == CATCH_MISSED ? 1 : 0;
+        MetricsOutcome(record.outcome);
+        correction.Update(record);
+        if (!occlusion.Update(record) && io.verbose)
+            cerr << "[Speed] Launch " << record.launchId << ": occlusion speeds " << occlusion.Speed(record.occlusion[0])
+                 << " / " << occlusion.Speed(record.occlusion[1]) << " m/s disagree with " << record.speed
+                 << " m/s between the beams.\n";
+        stats.statistics.Add(record);
+        if (history)
+            history->Append(record, stats.rig);
+        if (recommender)
+            recommender->Record(record);
+        if (MetricsActive())
+        {
+            statsBlob.clear();
+            stats.statistics.Serialize(statsBlob);
+            MetricsStatistics(statsBlob.data(), statsBlob.size());
+        }
+    };
+    auto drain = [&]() {
+        LaunchRecord landed;
+        while (tracker.PopLanded(landed))
+            finish(landed);
+    };
+    // Waits out the cars still in the air and stops tracking.
+    auto landAll = [&]() {
+        if (!io.tracker)
+            return;
+        io.WaitLanded(MOTION_DONE_TIMEOUT);
+        tracker.ForceLand();
+        drain();
+        io.tracker = nullptr;
+    };
+
+    double angle = 0.0;
+    while (!io.Aborted() && nextAngle(angle))
+    {
+        // Parameters are fixed for the whole launch; reloads land between launches.
+        const Params &params = ParamsAcquire(paramsReader);
+        bool pipelined = params.launch.pipelineCars;
+        if (!pipelined)
+            landAll();
+        io.tracker = pipelined ? &tracker : nullptr;
+        io.landingCorrection = params.launch.landingCorrection ? &correction : nullptr;
+
+        // A faulted axis is recovered here rather than ending the session.
+        if (!SuperviseAxes(io, params.launch, stats.recovery))
+        {
+            int64_t dwell = SecondsToNs(params.launch.postLaunchDwell);
+            ParamsRelease(paramsReader);
+            clock.SleepFor(dwell);
+            continue;
+        }
+
+        // Pipelined, the next car goes onto the ramp as soon as the last one is clear of sensor 2.
+        if (pipelined && !io.WaitAdmit(params.launch.sensor2Timeout))
+        {
+            if (!io.Aborted())
+                cerr << "[Tracker] Sensor 2 still blocked, not admitting the next car.\n";
+            ParamsRelease(paramsReader);
+            continue;
+        }
+
+        LaunchRecord single;
+        LaunchRecord &record = pipelined ? tracker.Admit(params.launch.sensorDistance) : single;
+        record.launchId = static_cast<uint32_t>(stats.launches);
+        record.wallTime = chrono::duration<double>(chrono::system_clock::now().time_since_epoch()).count();
+        io.LaunchBegin(record.launchId);
+        auto launchStart = chrono::steady_clock::now();
+        bool completed = RunLaunch(io, angle - params.launch.angleOffset, record, params.launch);
+        int64_t launchNs = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - launchStart).count();
+        io.LaunchEnd();
+        if (pipelined)
+        {
+            if (!completed && tracker.LaunchingEdge(1) < 0)
+                cerr << "[Tracker] Launch " << record.launchId << ": sensor 2 before sensor 1, car not timed.\n";
+            if (completed)
+                tracker.Launched(params.launch);
+            else
+                tracker.Drop();
+        }
+
+        stats.launches++;
+        stats.recovery.abortedLaunches += io.axisFaults ? 1 : 0;
+        stats.launchWallNsSum += launchNs;
+        stats.launchWallNsMax = max(stats.launchWallNsMax, launchNs);
+        if (completed)
+        {
+            stats.completed++;
+            stats.feasible += record.feasible ? 1 : 0;
+            stats.marginSum += record.margin;
+            stats.reactionSum += record.catcherCmd;
+            stats.reactionMax = max(stats.reactionMax, record.catcherCmd);
+            if (log)
+                log->Write(record);
+        }
+
+        if (pipelined)
+        {
+            // Landed cars are finished here; a failed launch still holds the dwell.
+            if (!completed)
+            {
+                io.WaitLanded(MOTION_DONE_TIMEOUT);
+                PaceLaunch(io, record, params.launch);
+            }
+            ParamsRelease(paramsReader);
+            drain();
+            continue;
+        }
+        PaceLaunch(io, record, params.launch);
+        ParamsRelease(paramsReader);
+        if (completed)
+            finish(record);
+    }
+    landAll();
+
+    io.landingCorrection = nullptr;
+    io.occlusion = nullptr;
+    stats.tracking = tracker.Stats();
+    stats.correction = correction.Stats();
+    stats.occlusion = occlusion.Stats();
+    stats.clockSeconds += clock.NowSeconds() - clockStart;
+    stats.wallSeconds += chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+    stats.cpuSeconds += ThreadCpuSeconds() - cpuStart;
+    stats.loopWakeup = JitterWakeups();
+    stats.loopExec = JitterExec();
+    ParamsUnregisterReader(paramsReader);
+}
+
+// === THREADS ===
+bool PinThisThread(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (result != 0)
+    {
+        cerr << "[Rig] Could not pin to CPU " << cpu << ": " << strerror(result) << endl;
+        return false;
+    }
+    return true;
+}
+
+thread StartRigThread(int rig, int cpu, function<void()> body)
+{
+    return thread([rig, cpu, body = move(body)]() {
+        char name[16];
+        snprintf(name, sizeof(name), "hotwheels-rig%d", rig);
+        pthread_setname_np(pthread_self(), name);
+        if (cpu >= 0)
+            PinThisThread(cpu);
+        body();
+    });
+}
+
+string RigPath(const string &path, int rig)
+{
+    if (rig == 0)
+        return path;
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of('/');
+    if (dot == string::npos || (slash != string::npos && dot < slash))
+        dot = path.size();
+    return path.substr(0, dot) + "_rig" + to_string(rig) + path.substr(dot);
+}
+
+// === STATS ===
+void PrintRigStats(const vector<RigStats> &stats)
+{
+    auto total = make_unique<RigStats>();
+    printf("%-5s %9s %9s %9s %9s %9s %11s %13s %12s %14s %13s %9s\n", "rig", "launches", "complete", "feasible",
+           "caught", "missed", "margin_ms", "reaction_ms", "react_max", "launch_us", "launch_max", "cpu_s");
+    auto printRow = [](const char *label, const RigStats &s) {
+        double completed = s.completed ? static_cast<double>(s.completed) : 1.0;
+        double launches = s.launches ? static_cast<double>(s.launches) : 1.0;
+        printf("%-5s %9llu %9llu %9llu %9llu %9llu %11.2f %13.3f %12.3f %14.1f %13.1f %9.3f\n", label,
+               (unsigned long long)s.launches, (unsigned long long)s.completed, (unsigned long long)s.feasible,
+               (unsigned long long)s.caught, (unsigned long long)s.missed,
+               s.marginSum / completed * 1000.0, s.reactionSum / completed * 1000.0, s.reactionMax * 1000.0,
+               s.launchWallNsSum / launches / 1000.0, s.launchWallNsMax / 1000.0, s.cpuSeconds);
+    };
+    for (const RigStats &s : stats)
+    {
+        printRow(to_string(s.rig).c_str(), s);
+        total->launches += s.launches;
+        total->completed += s.completed;
+        total->feasible += s.feasible;
+        total->caught += s.caught;
+        total->missed += s.missed;
+        total->marginSum += s.marginSum;
+        total->reactionSum += s.reactionSum;
+        total->reactionMax = max(total->reactionMax, s.reactionMax);
+        total->launchWallNsSum += s.launchWallNsSum;
+        total->launchWallNsMax = max(total->launchWallNsMax, s.launchWallNsMax);
+        total->clockSeconds = max(total->clockSeconds, s.clockSeconds);
+        total->wallSeconds = max(total->wallSeconds, s.wallSeconds);
+        total->cpuSeconds += s.cpuSeconds;
+        total->recovery.Merge(s.recovery);
+        total->tracking.Merge(s.tracking);
+    }
+    if (stats.size() > 1)
+        printRow("all", *total);
+    if (total->wallSeconds > 0.0)
+        printf("throughput: %.1f launches/s wall, %.1f launches/h rig time\n", total->launches / total->wallSeconds,
+               total->clockSeconds > 0.0 ? total->launches / total->clockSeconds * 3600.0 : 0.0);
+    for (const RigStats &s : stats)
+    {
+        PrintTrackerStats(s.rig, s.tracking);
+        PrintCorrectionStats(s.rig, s.correction);
+        PrintOcclusionStats(s.rig, s.occlusion);
+        PrintRecoveryStats(s.rig, s.recovery);
+    }
+
+    auto merged = make_unique<LaunchStatistics>(); // ~200 KiB of sketches, keep it off the stack
+    for (const RigStats &s : stats)
+        merged->Merge(s.statistics);
+    merged->Print();
+}
+
+void PrintRigJitter(const RigStats &stats)
+{
+    printf("[Rig %d] Control loop timing:\n", stats.rig);
+    JitterPrint(stats.loopWakeup, stats.loopExec);
+}
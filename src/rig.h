@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "car_tracker.h"
+#include "fault_supervisor.h"
+#include "jitter_monitor.h"
+#include "landing_correction.h"
+#include "launch_pipeline.h"
+#include "occlusion_speed.h"
+#include "stream_stats.h"
+
+class AngleRecommender;
+class HistoryWriter;
+class LaunchLogWriter;
+
+// === RIGS ===
+// One ramp/door/catcher set and its two beams. Each rig has its own axis/IO
+// mapping, LaunchIO, metrics page, launch log and control thread; rigs share
+// nothing on the hot path except read-only parameter snapshots, so N rigs on
+// one controller only compete for cores.
+
+constexpr int MAX_RIGS = 8;
+
+struct RigConfig
+{
+    int axisNumbers[AXIS_COUNT] = {RAMP, DOOR, CATCHER}; // controller axis for each role
+    int sensorNode = 1;                                  // network node carrying both beams
+    int sensorInputs[2] = {1, 0};                        // digital input for sensor 1 and sensor 2
+    int cpu = -1;                                        // control thread core, -1 = not pinned
+    std::vector<double> angles;                          // deg, cycled when there is no operator prompt
+
+    bool operator==(const RigConfig &other) const = default;
+};
+
+// Rig N defaults to rig 0's layout shifted by N drives: axes 3N..3N+2, beams on node 3N+1.
+RigConfig DefaultRigConfig(int rig);
+
+// Owned and written by the rig's control thread only; read after it joins.
+struct alignas(64) RigStats
+{
+    int rig = 0;
+    uint64_t launches = 0;
+    uint64_t completed = 0;       // reached the catcher command
+    uint64_t feasible = 0;
+    uint64_t caught = 0;          // completed launches by detected outcome (catch_detector.h)
+    uint64_t missed = 0;
+    double marginSum = 0.0;       // s, completed launches
+    double reactionSum = 0.0;     // s, sensor 2 edge to catcher command
+    double reactionMax = 0.0;
+    int64_t launchWallNsSum = 0;  // real time spent inside RunLaunch
+    int64_t launchWallNsMax = 0;
+    double clockSeconds = 0.0;    // rig clock time covered (virtual in simulation)
+    double wallSeconds = 0.0;
+    double cpuSeconds = 0.0;      // control thread CPU time
+    JitterHistogram loopWakeup{}; // control-loop histograms of the rig thread
+    JitterHistogram loopExec{};
+    LaunchStatistics statistics;  // completed launches; mergeable across rigs
+    RecoveryStats recovery;       // axis faults and how the supervisor handled them
+    TrackerStats tracking;        // pipelined cars (pipeline_cars)
+    CorrectionStats correction;   // landing model fit (landing_correction)
+    OcclusionStats occlusion;     // car length and occlusion speeds (early_catcher)
+};
+
+// Supplies the next ramp angle; false ends the session.
+using AngleSource = std::function<bool(double &angle)>;
+
+// Cycles through `angles`, stopping after `launches` (0 = never).
+AngleSource CycleAngles(std::vector<double> angles, uint64_t launches = 0);
+
+// Runs launches on the calling thread until the angle source ends or the I/O
+// aborts. Takes a parameter snapshot per launch and has the fault supervisor
+// check the axes before each one. Each caught car refines the rig's landing
+// correction once it has landed, and every completed launch the car length
+// its occlusion timer works from. With pipeline_cars the next launch starts
+// as soon as the last car clears sensor 2, and a car tracker finishes each
+// car when it lands. `log`, `history` and `recommender` may be null; the
+// history store may be shared by all rigs. The recommender, if any, is fed
+// every completed launch and must only be used from this thread.
+void RunRig(LaunchIO &io, const AngleSource &nextAngle, RigStats &stats, LaunchLogWriter *log = nullptr,
+            HistoryWriter *history = nullptr, AngleRecommender *recommender = nullptr);
+
+// Starts a rig control thread, pinned to `cpu` (if >= 0) before `body` runs.
+std::thread StartRigThread(int rig, int cpu, std::function<void()> body);
+bool PinThisThread(int cpu);
+
+// Per-rig file name: rig 0 keeps `path`, rig N gets "_rigN" before the extension.
+std::string RigPath(const std::string &path, int rig);
+
+// Per-rig table plus an aggregate row and the merged launch statistics.
+void PrintRigStats(const std::vector<RigStats> &stats);
+void PrintRigJitter(const RigStats &stats);
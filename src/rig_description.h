@@ -0,0 +1,116 @@
+#pragma once
+
+// === ENUMS ===
+enum AxisID
+{
+    RAMP = 0,
+    DOOR = 1,
+    CATCHER = 2
+};
+constexpr int AXIS_COUNT = 3;
+constexpr const char *AXIS_NAMES[AXIS_COUNT] = {"ramp", "door", "catcher"}; // also the parameter key prefixes
+
+// === MOTION PROFILES ===
+struct MotionProfile
+{
+    double velocity;
+    double acceleration;
+    double deceleration;
+    double jerkPercent; // 0 = trapezoidal
+
+    bool operator==(const MotionProfile &other) const = default;
+};
+
+// === RIG DESCRIPTION ===
+// Everything fixed by the hardware of one rig: what each axis moves in, its
+// encoder scaling, default profile and travel, and the beam/ramp geometry.
+// Descriptions are constexpr and checked at compile time by RigModel, which
+// also generates the per-axis conversions from them; launch_model.h takes
+// the demo rig's values as its defaults. Values that may be retuned at
+// runtime (profiles, geometry) still live in LaunchParams as well.
+
+enum AxisUnit
+{
+    UNIT_DEGREES = 0, // rotary: ramp angle, door angle
+    UNIT_METERS = 1   // linear: catcher carriage
+};
+
+struct AxisDescription
+{
+    AxisUnit unit;
+    double countsPerUnit;  // encoder counts per deg or m, set as the axis's user units
+    MotionProfile profile; // default, per unit
+    double minPosition;    // travel, units
+    double maxPosition;
+    double errorLimit;     // following error at which the controller aborts the axis, units
+    bool homeOnStart;      // home action DONE at startup (the catcher)
+};
+
+struct RigDescription
+{
+    const char *name;
+    AxisDescription axes[AXIS_COUNT];
+    double sensorDistance; // m between the two beams
+    double rampHeight;     // m, ramp exit above the catcher
+    double doorOpenBase;   // deg, the door opens to doorOpenBase - ramp angle
+};
+
+constexpr bool ProfileValid(const MotionProfile &profile)
+{
+    return profile.velocity > 0.0 && profile.acceleration > 0.0 && profile.deceleration > 0.0 &&
+           profile.jerkPercent >= 0.0 && profile.jerkPercent <= 100.0;
+}
+
+constexpr bool AxisValid(const AxisDescription &axis)
+{
+    return axis.countsPerUnit > 0.0 && ProfileValid(axis.profile) && axis.minPosition < axis.maxPosition &&
+           axis.errorLimit > 0.0;
+}
+
+// Compile-time view of one rig. Instantiating it checks the description;
+// its conversions index constexpr tables, so code built on it has no
+// branches on axis identity.
+template <const RigDescription &Rig>
+struct RigModel
+{
+    static_assert(Rig.axes[RAMP].unit == UNIT_DEGREES && Rig.axes[DOOR].unit == UNIT_DEGREES,
+                  "ramp and door are rotary axes in degrees");
+    static_assert(Rig.axes[CATCHER].unit == UNIT_METERS, "the catcher is a linear axis in meters");
+    static_assert(AxisValid(Rig.axes[RAMP]) && AxisValid(Rig.axes[DOOR]) && AxisValid(Rig.axes[CATCHER]),
+                  "every axis needs positive scaling and error limit, a valid profile and min < max travel");
+    static_assert(Rig.axes[RAMP].minPosition >= 0.0 && Rig.axes[RAMP].maxPosition <= 90.0,
+                  "ramp angles must lie within 0..90 deg");
+    static_assert(Rig.doorOpenBase - Rig.axes[RAMP].maxPosition >= Rig.axes[DOOR].minPosition &&
+                      Rig.doorOpenBase - Rig.axes[RAMP].minPosition <= Rig.axes[DOOR].maxPosition,
+                  "the door open angle must stay within door travel for every ramp angle");
+    static_assert(Rig.sensorDistance > 0.0 && Rig.rampHeight >= 0.0, "beam spacing and ramp height in meters");
+
+    static constexpr bool VALID = true;
+
+    static constexpr double COUNTS_PER_UNIT[AXIS_COUNT] = {
+        Rig.axes[RAMP].countsPerUnit, Rig.axes[DOOR].countsPerUnit, Rig.axes[CATCHER].countsPerUnit};
+    static constexpr double UNITS_PER_COUNT[AXIS_COUNT] = {
+        1.0 / Rig.axes[RAMP].countsPerUnit, 1.0 / Rig.axes[DOOR].countsPerUnit, 1.0 / Rig.axes[CATCHER].countsPerUnit};
+
+    static constexpr const AxisDescription &Axis(AxisID axis) { return Rig.axes[axis]; }
+    static constexpr double ToCounts(AxisID axis, double position) { return position * COUNTS_PER_UNIT[axis]; }
+    static constexpr double ToUnits(AxisID axis, double counts) { return counts * UNITS_PER_COUNT[axis]; }
+    static constexpr double DoorOpenAngle(double rampAngle) { return Rig.doorOpenBase - rampAngle; }
+};
+
+// === THE DEMO RIG ===
+constexpr RigDescription DEMO_RIG = {
+    "hotwheels-demo",
+    {
+        // unit         counts/unit   profile (v, a, d, jerk%)                  travel         error  home
+        {UNIT_DEGREES, 186413.5111, {50.0, 300.0, 300.0, 0.0},             0.0, 90.0,  0.5,   false}, // ramp
+        {UNIT_DEGREES, 186413.5111, {100000.0, 300000.0, 300000.0, 0.0},   0.0, 100.0, 20.0,  false}, // door, lags ~13 deg in the servo model
+        {UNIT_METERS, 8532248.0,    {20.0, 75.0, 75.0, 0.0},               0.0, 0.84,  0.5,   true},  // catcher
+    },
+    0.1,   // sensor distance, m
+    0.23,  // ramp height above the catcher, m
+    100.0, // door open base, deg
+};
+
+using DemoRig = RigModel<DEMO_RIG>;
+static_assert(DemoRig::VALID);
@@ -0,0 +1,203 @@
+#include "rt_setup.h"
+#include <algorithm>
+#include <alloca.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t PAGE_BYTES = 4096;
+    constexpr const char *ISOLATED_CPUS_PATH = "/sys/devices/system/cpu/isolated";
+
+    // Kernel cpulist format, e.g. "2-3,6".
+    vector<int> ParseCpuList(const string &text)
+    {
+        vector<int> cpus;
+        size_t start = 0;
+        while (start < text.size())
+        {
+            size_t comma = text.find(',', start);
+            if (comma == string::npos)
+                comma = text.size();
+            string range = text.substr(start, comma - start);
+            int first = 0, last = 0;
+            int fields = sscanf(range.c_str(), "%d-%d", &first, &last);
+            if (fields >= 1)
+            {
+                if (fields == 1)
+                    last = first;
+                for (int cpu = first; cpu <= last; cpu++)
+                    cpus.push_back(cpu);
+            }
+            start = comma + 1;
+        }
+        return cpus;
+    }
+
+    vector<int> IsolatedCpus()
+    {
+        ifstream file(ISOLATED_CPUS_PATH);
+        string text;
+        getline(file, text);
+        return ParseCpuList(text);
+    }
+
+    vector<int> AllowedCpus()
+    {
+        vector<int> cpus;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) != 0)
+            return cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET(cpu, &set))
+                cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    int PolicyValue(const string &policy)
+    {
+        if (policy == "fifo")
+            return SCHED_FIFO;
+        if (policy == "rr")
+            return SCHED_RR;
+        return SCHED_OTHER;
+    }
+}
+
+bool RtPolicyValid(const string &policy)
+{
+    return policy == "other" || policy == "fifo" || policy == "rr";
+}
+
+// === PROCESS ===
+void RtSetupProcess(const RtConfig &config)
+{
+    if (config.lockMemory)
+    {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+            cout << "[RT] Memory locked (mlockall).\n";
+        else
+            cerr << "[RT] mlockall failed: " << strerror(errno) << " (needs CAP_IPC_LOCK or RLIMIT_MEMLOCK), page faults stay possible.\n";
+    }
+
+    // Keep freed memory in the arena and serve large blocks from it too, so the
+    // pre-faulted pages are what later allocations get.
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+    if (config.prefaultHeapKb > 0)
+    {
+        size_t bytes = config.prefaultHeapKb * 1024;
+        char *heap = static_cast<char *>(malloc(bytes));
+        if (heap)
+        {
+            for (size_t offset = 0; offset < bytes; offset += PAGE_BYTES)
+                heap[offset] = 0;
+            free(heap);
+            cout << "[RT] Pre-faulted " << config.prefaultHeapKb << " KiB of heap.\n";
+        }
+    }
+}
+
+// === THREAD ===
+void RtSetupThread(const RtConfig &config)
+{
+    int policy = PolicyValue(config.policy);
+    sched_param param{};
+    param.sched_priority = (policy == SCHED_OTHER) ? 0 : config.priority;
+    int result = pthread_setschedparam(pthread_self(), policy, &param);
+    if (result != 0)
+        cerr << "[RT] Could not set " << config.policy << " priority " << param.sched_priority << ": " << strerror(result)
+             << " (needs CAP_SYS_NICE or RLIMIT_RTPRIO), running as SCHED_OTHER.\n";
+    else if (policy != SCHED_OTHER)
+        cout << "[RT] Control thread on SCHED_" << (policy == SCHED_FIFO ? "FIFO" : "RR") << " priority " << config.priority << "\n";
+
+    if (config.prefaultStackKb > 0)
+    {
+        // Touch the stack this thread will grow into so the first deep call in a launch does not fault.
+        size_t bytes = config.prefaultStackKb * 1024;
+        volatile char *stack = static_cast<volatile char *>(alloca(bytes));
+        for (size_t offset = 0; offset < bytes; offset += PAGE_BYTES)
+            stack[offset] = 0;
+    }
+}
+
+// === CPU PLACEMENT ===
+int RtControlCpu(int rig, int rmpCpu)
+{
+    vector<int> allowed = AllowedCpus();
+    allowed.erase(remove(allowed.begin(), allowed.end(), rmpCpu), allowed.end());
+
+    vector<int> pool;
+    for (int cpu : IsolatedCpus())
+    {
+        if (find(allowed.begin(), allowed.end(), cpu) != allowed.end())
+            pool.push_back(cpu);
+    }
+    if (pool.empty())
+        pool = allowed;
+    if (pool.empty())
+        return -1;
+    // Highest cores first: housekeeping and IRQs usually sit on the low ones.
+    return pool[pool.size() - 1 - rig % pool.size()];
+}
+
+void RtCheckIsolation(int cpu)
+{
+    if (cpu < 0)
+    {
+        cerr << "[RT] Control thread is not pinned; the scheduler may move it onto a busy core.\n";
+        return;
+    }
+    vector<int> isolated = IsolatedCpus();
+    if (find(isolated.begin(), isolated.end(), cpu) == isolated.end())
+        cerr << "[RT] CPU " << cpu << " is not isolated (boot with isolcpus=/nohz_full= to keep other tasks and ticks off it).\n";
+}
+
+// === MEASUREMENT ===
+void RtMeasureWakeups(double seconds, int periodUs)
+{
+    size_t count = static_cast<size_t>(seconds * 1e6 / periodUs);
+    vector<int64_t> latencies;
+    latencies.reserve(count);
+
+    timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for (size_t i = 0; i < count; i++)
+    {
+        next.tv_nsec += periodUs * 1000L;
+        while (next.tv_nsec >= 1000000000L)
+        {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        latencies.push_back((now.tv_sec - next.tv_sec) * 1000000000L + (now.tv_nsec - next.tv_nsec));
+    }
+    if (latencies.empty())
+        return;
+
+    sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return latencies[min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))] / 1000.0;
+    };
+    printf("[RT] %zu wake-ups every %d us: min %.1f | p50 %.1f | p99 %.1f | p99.9 %.1f | max %.1f us\n",
+           latencies.size(), periodUs, latencies.front() / 1000.0, percentile(0.5), percentile(0.99),
+           percentile(0.999), latencies.back() / 1000.0);
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// === REAL-TIME SETUP ===
+// Host-side settings for the control threads; the RMP firmware thread is
+// configured separately through cpu_affinity. Everything here is best-effort:
+// without CAP_SYS_NICE / CAP_IPC_LOCK (or matching rlimits) a step warns and
+// the demo carries on as an ordinary process.
+
+struct RtConfig
+{
+    std::string policy = "fifo";     // other | fifo | rr
+    int priority = 80;               // 1..99 for fifo/rr, kept below the kernel's IRQ threads
+    bool lockMemory = true;          // mlockall(MCL_CURRENT | MCL_FUTURE)
+    size_t prefaultStackKb = 256;    // per control thread
+    size_t prefaultHeapKb = 8192;    // touched once and kept by malloc
+
+    bool operator==(const RtConfig &other) const = default;
+};
+
+bool RtPolicyValid(const std::string &policy);
+
+// Once per process, before the control threads start: locks memory, stops
+// malloc from returning memory to the kernel and pre-faults the heap.
+void RtSetupProcess(const RtConfig &config);
+
+// On each control thread, after it is pinned: scheduling policy/priority and
+// stack pre-faulting.
+void RtSetupThread(const RtConfig &config);
+
+// Core for a rig control thread when none is configured: an isolated core if
+// there is one, never the RMP core, spreading rigs over the remaining CPUs.
+// -1 if the process has no other core to give.
+int RtControlCpu(int rig, int rmpCpu);
+
+// Warns when a control core is not in /sys/devices/system/cpu/isolated.
+void RtCheckIsolation(int cpu);
+
+// cyclictest-style check: sleeps `periodUs` repeatedly for `seconds` on the
+// calling thread and prints the wake-up latency distribution.
+void RtMeasureWakeups(double seconds, int periodUs = 1000);
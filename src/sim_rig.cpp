@@ -0,0 +1,449 @@
+#include "sim_rig.h"
+#include "angle_recommender.h"
+#include "launch_history.h"
+#include "launch_log.h"
+#include "params.h"
+#include "profile_tuner.h"
+#include "rig.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace std;
+
+// Distance covered after `elapsed` seconds of a trapezoidal move of `distance`.
+static double TrapezoidProgress(const MotionProfile &profile, double distance, double elapsed)
+{
+    if (elapsed <= 0.0)
+        return 0.0;
+    double total = ComputeTrapezoidTime(profile, distance);
+    if (elapsed >= total)
+        return distance;
+    double a = profile.acceleration, d = profile.deceleration;
+    double peak = min(profile.velocity, sqrt(2.0 * distance * a * d / (a + d)));
+    double accelTime = peak / a;
+    double decelStart = total - peak / d;
+    if (elapsed <= accelTime)
+        return 0.5 * a * elapsed * elapsed;
+    if (elapsed <= decelStart)
+        return 0.5 * peak * accelTime + peak * (elapsed - accelTime);
+    double remaining = total - elapsed;
+    return distance - 0.5 * d * remaining * remaining;
+}
+
+// Integral of TrapezoidProgress() over [0, elapsed].
+static double TrapezoidIntegral(const MotionProfile &profile, double distance, double elapsed)
+{
+    if (elapsed <= 0.0)
+        return 0.0;
+    double total = ComputeTrapezoidTime(profile, distance);
+    double a = profile.acceleration, d = profile.deceleration;
+    double peak = min(profile.velocity, sqrt(2.0 * distance * a * d / (a + d)));
+    double accelTime = peak / a;
+    double decelStart = total - peak / d;
+    double accelDistance = 0.5 * peak * accelTime;
+
+    double t = min(elapsed, accelTime);
+    double integral = a * t * t * t / 6.0;
+    if (elapsed <= accelTime)
+        return integral;
+    t = min(elapsed, decelStart) - accelTime;
+    integral += accelDistance * t + 0.5 * peak * t * t;
+    if (elapsed <= decelStart)
+        return integral;
+    double decelTime = total - decelStart;
+    double remaining = max(total - elapsed, 0.0);
+    integral += distance * (min(elapsed, total) - decelStart) -
+                d / 6.0 * (decelTime * decelTime * decelTime - remaining * remaining * remaining);
+    if (elapsed > total)
+        integral += distance * (elapsed - total);
+    return integral;
+}
+
+// The S-curve is the trapezoid averaged over one jerk ramp: the same target,
+// ramps of `jerkTime` at both ends of each acceleration phase.
+static double MoveProgress(const MotionProfile &profile, double distance, double jerkTime, double elapsed)
+{
+    if (jerkTime <= 0.0)
+        return TrapezoidProgress(profile, distance, elapsed);
+    return (TrapezoidIntegral(profile, distance, elapsed) - TrapezoidIntegral(profile, distance, elapsed - jerkTime)) / jerkTime;
+}
+
+static double MoveVelocity(const MotionProfile &profile, double distance, double jerkTime, double elapsed)
+{
+    if (jerkTime > 0.0)
+        return (TrapezoidProgress(profile, distance, elapsed) - TrapezoidProgress(profile, distance, elapsed - jerkTime)) / jerkTime;
+    constexpr double STEP = 1e-6;
+    return (TrapezoidProgress(profile, distance, elapsed + STEP) - TrapezoidProgress(profile, distance, elapsed)) / STEP;
+}
+
+SimLaunchIO::SimLaunchIO(uint32_t seed, bool servoModel) : servoModel(servoModel), rng(seed)
+{
+    verbose = false;
+}
+
+IoResult<bool> SimLaunchIO::SensorLevel(int sensor)
+{
+    double edge = sensorEdge[sensor - 1];
+    double now = Now();
+    return {edge >= 0.0 && now >= edge && now < edge + occlusion};
+}
+
+IoError SimLaunchIO::MoveAxis(AxisID axis, double pos, const MotionProfile &profile)
+{
+    Clock &clock = GetClock();
+    clock.SleepFor(SecondsToNs(SIM_COMMAND_LATENCY));
+
+    SimAxis &sim = axes[axis];
+    if (Faulted(axis))
+        return Fail(IO_AXIS_MOVE, axis, "move refused, axis faulted");
+    if (!sim.ampEnabled)
+        return Fail(IO_AXIS_MOVE, axis, "move refused, amp disabled");
+    double now = Now();
+    if (servoModel)
+    {
+        // The new trajectory starts where the old one is now; the servo carries its lag over.
+        TrackServo(axis, now);
+        sim.start = Reference(axis, now);
+    }
+    else
+        sim.start = Position(axis);
+    sim.target = pos;
+    sim.moveStart = now;
+    sim.profile = profile;
+    sim.jerkTime = ComputeJerkTime(profile, pos - sim.start);
+    sim.moveTime = ComputeMoveTime(profile, pos - sim.start);
+    sim.faultTime = -1.0;
+    if (faultRate > 0.0)
+    {
+        uniform_real_distribution<double> unit(0.0, 1.0);
+        if (unit(rng) < faultRate)
+        {
+            sim.faultTime = now + unit(rng) * sim.moveTime;
+            Fail(IO_OK, axis, "injected fault, trips during this move");
+        }
+    }
+
+    // A new ramp angle means the operator is about to drop the next car.
+    if (axis == RAMP)
+    {
+        double releaseTime = now + sim.moveTime + SIM_RELEASE_DELAY;
+        uint32_t release = ++rampMoves;
+        if (VirtualClock *virtualClock = dynamic_cast<VirtualClock *>(&clock))
+            virtualClock->Schedule(SecondsToNs(releaseTime), [this, releaseTime, release]() { ReleaseCar(releaseTime, release); });
+        else
+            ReleaseCar(releaseTime, release);
+    }
+    return IO_OK;
+}
+
+IoResult<double> SimLaunchIO::AxisActualPosition(AxisID axis)
+{
+    return {Position(axis)};
+}
+
+double SimLaunchIO::Reference(AxisID axis, double time)
+{
+    const SimAxis &sim = axes[axis];
+    double distance = fabs(sim.target - sim.start);
+    double travelled = MoveProgress(sim.profile, distance, sim.jerkTime, time - sim.moveStart);
+    return sim.start + copysign(travelled, sim.target - sim.start);
+}
+
+double SimLaunchIO::Position(AxisID axis)
+{
+    double now = Now();
+    if (axes[axis].faultTime >= 0.0)
+        now = min(now, axes[axis].faultTime); // a tripped axis stops where it was
+    if (!servoModel)
+        return Reference(axis, now);
+    TrackServo(axis, now);
+    return axes[axis].servoPosition;
+}
+
+// Second-order servo: x'' = w^2 (r - x) + 2 zeta w (r' - x'), stepped up to
+// `now`. Once the trajectory is over and the residual is negligible the axis
+// snaps to the target so idle time costs nothing. A step that finds the error
+// past the axis's error limit trips the axis there.
+void SimLaunchIO::TrackServo(AxisID axis, double now)
+{
+    SimAxis &sim = axes[axis];
+    if (now <= sim.servoTime)
+        return;
+    double direction = (sim.target >= sim.start) ? 1.0 : -1.0;
+    double distance = fabs(sim.target - sim.start);
+    double moveEnd = sim.moveStart + sim.moveTime;
+    constexpr double w = 2.0 * M_PI * SIM_SERVO_BANDWIDTH_HZ;
+    while (sim.servoTime < now)
+    {
+        if (sim.servoTime >= moveEnd && fabs(sim.servoPosition - sim.target) < SIM_SERVO_REST && fabs(sim.servoVelocity) < SIM_SERVO_REST)
+        {
+            sim.servoPosition = sim.target;
+            sim.servoVelocity = 0.0;
+            sim.servoError = 0.0;
+            sim.servoTime = now;
+            return;
+        }
+        double step = min(SIM_SERVO_STEP, now - sim.servoTime);
+        double elapsed = sim.servoTime - sim.moveStart;
+        double reference = sim.start + direction * MoveProgress(sim.profile, distance, sim.jerkTime, elapsed);
+        if ((sim.faultTime < 0.0 || sim.faultTime > sim.servoTime) &&
+            fabs(reference - sim.servoPosition) > DemoRig::Axis(axis).errorLimit)
+        {
+            // Like the live controller's error-limit abort: the axis stops here, faulted.
+            sim.faultTime = sim.servoTime;
+            sim.servoError = reference - sim.servoPosition;
+            Fail(IO_OK, axis, "following error over the limit");
+            return;
+        }
+        double referenceVelocity = direction * MoveVelocity(sim.profile, distance, sim.jerkTime, elapsed);
+        double acceleration = w * w * (reference - sim.servoPosition) +
+                              2.0 * SIM_SERVO_DAMPING * w * (referenceVelocity - sim.servoVelocity);
+        sim.servoVelocity += acceleration * step; // semi-implicit Euler
+        sim.servoPosition += sim.servoVelocity * step;
+        sim.servoTime += step;
+    }
+    sim.servoError = Reference(axis, now) - sim.servoPosition;
+}
+
+IoResult<bool> SimLaunchIO::MotionDone(AxisID axis)
+{
+    const SimAxis &sim = axes[axis];
+    double now = Now();
+    if (now < sim.moveStart + sim.moveTime || Faulted(axis))
+        return {false};
+    if (!servoModel)
+        return {true};
+    TrackServo(axis, now);
+    return {fabs(sim.servoError) <= SIM_SETTLE_TOLERANCE[axis]};
+}
+
+IoError SimLaunchIO::ReadStatus(StatusSnapshot &status)
+{
+    IoError error = LaunchIO::ReadStatus(status);
+    for (int a = 0; a < AXIS_COUNT; a++)
+    {
+        status.followingError[a] = servoModel ? axes[a].servoError : 0.0;
+        status.fault[a] = Faulted(static_cast<AxisID>(a));
+    }
+
+    double now = Now();
+    ResolveLandings(now);
+    double sinceImpact = now - impactTime;
+    if (impactTime >= 0.0 && sinceImpact < 10.0 * SIM_IMPACT_DECAY)
+    {
+        double envelope = exp(-sinceImpact / SIM_IMPACT_DECAY);
+        double knock = SIM_IMPACT_AMPLITUDE * envelope * sin(2.0 * M_PI * SIM_IMPACT_FREQUENCY_HZ * sinceImpact);
+        status.followingError[CATCHER] += knock;
+        status.actualPosition[CATCHER] -= knock;
+        status.filterOutput[CATCHER] += SIM_IMPACT_OUTPUT * envelope;
+    }
+    return error;
+}
+
+// A car that has come down lands in the catcher if the catcher is under it.
+void SimLaunchIO::ResolveLandings(double now)
+{
+    for (SimLanding &landing : landings)
+    {
+        if (landing.time < 0.0 || now < landing.time)
+            continue;
+        if (!Faulted(CATCHER) && fabs(Position(CATCHER) - landing.position) <= SIM_CATCHER_HALF_WIDTH)
+            impactTime = landing.time;
+        landing.time = -1.0;
+    }
+}
+
+bool SimLaunchIO::Faulted(AxisID axis)
+{
+    return axes[axis].faultTime >= 0.0 && Now() >= axes[axis].faultTime;
+}
+
+// Like the live rig's: a fixed buffer, nothing allocates on the hot path.
+IoError SimLaunchIO::Fail(IoError error, AxisID axis, const char *message)
+{
+    snprintf(errorDetail, sizeof(errorDetail), "%s: %s", AXIS_NAMES[axis], message);
+    return error;
+}
+
+// A tripped drive also drops its amp enable.
+IoResult<AxisHealth> SimLaunchIO::ReadAxisHealth(AxisID axis)
+{
+    bool faulted = Faulted(axis);
+    return {AxisHealth{faulted, axes[axis].ampEnabled && !faulted}};
+}
+
+// Leaves the axis at rest where it stopped, amp off.
+IoError SimLaunchIO::ClearAxisFault(AxisID axis)
+{
+    GetClock().SleepFor(SecondsToNs(SIM_COMMAND_LATENCY));
+    if (!Faulted(axis))
+        return IO_OK;
+    SimAxis &sim = axes[axis];
+    double now = Now();
+    double position = Position(axis);
+    sim.start = sim.target = position;
+    sim.moveStart = now;
+    sim.moveTime = sim.jerkTime = 0.0;
+    sim.servoPosition = position;
+    sim.servoVelocity = sim.servoError = 0.0;
+    sim.servoTime = now;
+    sim.faultTime = -1.0;
+    sim.ampEnabled = false;
+    return IO_OK;
+}
+
+IoError SimLaunchIO::EnableAxis(AxisID axis)
+{
+    GetClock().SleepFor(SecondsToNs(SIM_COMMAND_LATENCY));
+    axes[axis].ampEnabled = true;
+    return IO_OK;
+}
+
+// Only the latest ramp move drops a car, and not if that move trips the ramp.
+void SimLaunchIO::ReleaseCar(double releaseTime, uint32_t release)
+{
+    if (release != rampMoves || axes[RAMP].faultTime >= 0.0)
+        return;
+    double angleRad = axes[RAMP].target * M_PI / 180.0;
+    double ideal = sqrt(2.0 * GRAVITY * SIM_RAMP_LENGTH * max(sin(angleRad), 0.0)) * SIM_SPEED_EFFICIENCY;
+    normal_distribution<double> noise(1.0, SIM_SPEED_NOISE);
+    double speed = max(ideal * noise(rng), 0.05);
+
+    // Time to roll down the ramp under constant acceleration to `speed`.
+    double rollTime = 2.0 * SIM_RAMP_LENGTH / speed;
+    sensorEdge[0] = releaseTime + rollTime;
+    sensorEdge[1] = sensorEdge[0] + SENSOR_DISTANCE / speed;
+    occlusion = SIM_CAR_LENGTH / speed;
+
+    SimLanding &landing = landings[nextLanding++ % SIM_MAX_LANDINGS];
+    landing.time = sensorEdge[1] + ComputeTimeOfFlight(speed, axes[RAMP].target, SIM_RAMP_HEIGHT);
+    landing.position = ComputeLandingPosition(speed, axes[RAMP].target, SIM_RAMP_HEIGHT);
+}
+
+int RunSimulation(int launches, bool virtualTime, bool autoAngle, double faultRate)
+{
+    Clock &previousClock = GetClock();
+    VirtualClock virtualClock;
+    if (virtualTime)
+        SetClock(virtualClock);
+
+    SimLaunchIO io;
+    io.faultRate = faultRate;
+    LaunchLogWriter launchLog;
+    launchLog.Open("hotwheels_sim_launches.csv");
+    HistoryWriter history;
+    history.Open(SIM_HISTORY_PATH);
+
+    AngleSource cycle = CycleAngles(SIM_ANGLES, launches);
+    AngleRecommender recommender(SIM_HISTORY_PATH);
+    int started = 0, recommended = 0;
+    auto nextAngle = [&](double &angle) {
+        if (started++ >= launches)
+            return false;
+        AngleScore best;
+        if (!autoAngle || !recommender.Recommend(io, best))
+            return cycle(angle);
+        angle = best.angle + recommender.AngleOffset();
+        recommended++;
+        return true;
+    };
+
+    auto rigStats = make_unique<RigStats>(); // ~200 KiB of sketches, keep it off the stack
+    RigStats &stats = *rigStats;
+    RunRig(io, nextAngle, stats, &launchLog, &history, &recommender);
+
+    double simulated = stats.clockSeconds;
+    double wall = stats.wallSeconds;
+    cout << "[Sim] " << launches << " launches | simulated " << simulated << " s in " << wall << " s wall"
+         << " (x" << (wall > 0.0 ? simulated / wall : 0.0) << ")"
+         << " | feasible: " << stats.feasible << " | mean margin: " << (launches ? stats.marginSum / launches * 1000.0 : 0.0) << " ms"
+         << " | caught: " << stats.caught << ", missed: " << stats.missed << "\n";
+    if (autoAngle)
+        cout << "[Sim] " << recommended << " of " << launches << " launches at the recommended angle\n";
+    PrintTrackerStats(stats.rig, stats.tracking);
+    PrintCorrectionStats(stats.rig, stats.correction);
+    PrintOcclusionStats(stats.rig, stats.occlusion);
+    PrintRecoveryStats(stats.rig, stats.recovery);
+    stats.statistics.Print();
+
+    SetClock(previousClock);
+    return 0;
+}
+
+// === PROFILE TUNING ===
+int RunTuningSimulation(int axis, const char *applyPath)
+{
+    Clock &previousClock = GetClock();
+    VirtualClock virtualClock;
+    SetClock(virtualClock);
+
+    SimLaunchIO io(1, true);
+    cout << "[Sim] Tuning against the servo model (" << SIM_SERVO_BANDWIDTH_HZ << " Hz, damping " << SIM_SERVO_DAMPING << ")\n";
+    int result = RunProfileTuning(io, axis, applyPath);
+
+    SetClock(previousClock);
+    return result;
+}
+
+// === MULTI-RIG BENCHMARK ===
+int RunRigBenchmark(int maxRigs, int launchesPerRig)
+{
+    int cores = static_cast<int>(thread::hardware_concurrency());
+    if (maxRigs < 1 || launchesPerRig < 1)
+    {
+        cerr << "[Bench] Need at least one rig and one launch per rig.\n";
+        return 1;
+    }
+    cout << "[Bench] " << launchesPerRig << " simulated launches per rig, " << cores << " CPUs\n";
+
+    vector<int> rigCounts;
+    for (int rigs = 1; rigs < maxRigs; rigs *= 2)
+        rigCounts.push_back(rigs);
+    rigCounts.push_back(maxRigs);
+
+    double singleRate = 0.0;
+    printf("%5s %10s %10s %14s %14s %11s %13s\n", "rigs", "launches", "wall_s", "launches/s", "per_rig/s",
+           "efficiency", "launch_max_us");
+    for (int rigs : rigCounts)
+    {
+        vector<RigStats> stats(rigs);
+        vector<thread> threads;
+        for (int r = 0; r < rigs; r++)
+        {
+            stats[r].rig = r;
+            // Each rig gets its own virtual clock and seed, so rigs never touch shared state.
+            threads.push_back(StartRigThread(r, cores > 0 ? r % cores : -1, [&stats, r, launchesPerRig]() {
+                VirtualClock clock;
+                SetThreadClock(&clock);
+                SimLaunchIO io(static_cast<uint32_t>(r + 1));
+                RunRig(io, CycleAngles(SIM_ANGLES, launchesPerRig), stats[r]);
+                SetThreadClock(nullptr);
+            }));
+        }
+        for (thread &t : threads)
+            t.join();
+
+        uint64_t launches = 0;
+        double wall = 0.0;
+        int64_t launchMaxNs = 0;
+        for (const RigStats &s : stats)
+        {
+            launches += s.launches;
+            wall = max(wall, s.wallSeconds);
+            launchMaxNs = max(launchMaxNs, s.launchWallNsMax);
+        }
+        double rate = wall > 0.0 ? launches / wall : 0.0;
+        if (rigs == 1)
+            singleRate = rate;
+        printf("%5d %10llu %10.3f %14.0f %14.0f %10.0f%% %13.1f\n", rigs, (unsigned long long)launches, wall, rate,
+               rate / rigs, singleRate > 0.0 ? rate / (singleRate * rigs) * 100.0 : 0.0, launchMaxNs / 1000.0);
+        if (rigs == maxRigs)
+            PrintRigStats(stats);
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "launch_pipeline.h"
+
+// === SIMULATED RIG ===
+// A kinematic stand-in for the ramp, door, catcher and both beams. Axes follow
+// their S-curve profiles on the global clock; a car is released a short
+// while after the ramp stops and rolls through the beams at a speed that
+// depends on the ramp angle, with seeded noise so runs are repeatable.
+// With the servo model on, each axis also lags its trajectory like a tuned
+// position loop: following error grows with acceleration and jerk, and motion
+// is only done once the error settles inside SIM_SETTLE_TOLERANCE. An axis
+// whose error passes its error limit in the rig description trips, as the
+// live controller's error-limit abort does.
+// With faultRate > 0 any commanded move may also trip its axis partway
+// through. Either way the axis stops where it is, reports the fault and
+// refuses moves until the fault is cleared and the amp re-enabled.
+// Every released car flies the launch model's trajectory from sensor 2, off a
+// ramp SIM_RAMP_HEIGHT high, which the model's RAMP_HEIGHT underestimates. If
+// the catcher is within SIM_CATCHER_HALF_WIDTH of the landing point when it
+// comes down, the catcher's status shows a decaying knock in following error,
+// position and filter output for the catch detector to find.
+
+constexpr double SIM_RAMP_LENGTH = 0.6;        // m rolled before sensor 1
+constexpr double SIM_SPEED_EFFICIENCY = 0.8;   // friction/rolling losses
+constexpr double SIM_SPEED_NOISE = 0.03;       // relative std dev
+constexpr double SIM_CAR_LENGTH = 0.075;       // m
+constexpr double SIM_RELEASE_DELAY = 1.0;      // s after the ramp stops
+constexpr double SIM_COMMAND_LATENCY = 0.0005; // s per axis command round trip
+constexpr double SIM_SERVO_BANDWIDTH_HZ = 25.0; // servo model: closed-loop natural frequency
+constexpr double SIM_SERVO_DAMPING = 0.5;       // servo model: damping ratio, < 1 overshoots
+constexpr double SIM_SERVO_STEP = 50e-6;        // s, servo model integration step
+constexpr double SIM_SERVO_REST = 1e-9;         // position/velocity residual treated as at rest
+constexpr double SIM_SETTLE_TOLERANCE[AXIS_COUNT] = {0.05, 0.2, 0.0005}; // deg, deg, m: motion done window
+constexpr double SIM_RAMP_HEIGHT = 0.28;         // m, the true height; the landing correction learns the difference
+constexpr double SIM_CATCHER_HALF_WIDTH = 0.04;  // m either side of the catcher position that catches a car
+constexpr double SIM_IMPACT_AMPLITUDE = 0.002;   // m, peak following error of the knock
+constexpr double SIM_IMPACT_OUTPUT = 30.0;       // % filter output at the knock
+constexpr double SIM_IMPACT_FREQUENCY_HZ = 40.0; // carriage ringing after the knock
+constexpr double SIM_IMPACT_DECAY = 0.03;        // s time constant
+constexpr int SIM_MAX_LANDINGS = 4;              // cars in the air at once
+constexpr const char *SIM_HISTORY_PATH = "hotwheels_sim_history";
+inline const std::vector<double> SIM_ANGLES = {20.0, 25.0, 30.0, 35.0, 40.0}; // deg, cycled
+
+class SimLaunchIO : public LaunchIO
+{
+public:
+    explicit SimLaunchIO(uint32_t seed = 1, bool servoModel = false);
+
+    IoResult<bool> SensorLevel(int sensor) override;
+    IoError MoveAxis(AxisID axis, double pos, const MotionProfile &profile) override;
+    IoResult<double> AxisActualPosition(AxisID axis) override;
+    IoResult<bool> MotionDone(AxisID axis) override;
+    IoError ReadStatus(StatusSnapshot &status) override; // adds the servo model's following error and faults
+    IoResult<AxisHealth> ReadAxisHealth(AxisID axis) override;
+    IoError ClearAxisFault(AxisID axis) override;
+    IoError EnableAxis(AxisID axis) override;
+    const char *ErrorDetail() override { return errorDetail; }
+
+    double faultRate = 0.0; // probability that a move trips its axis
+
+private:
+    struct SimAxis
+    {
+        double start = 0.0;
+        double target = 0.0;
+        double moveStart = 0.0; // s
+        double moveTime = 0.0;  // s
+        double jerkTime = 0.0;  // s, see ComputeJerkTime()
+        MotionProfile profile = RAMP_PROFILE;
+
+        // Servo model state.
+        double servoPosition = 0.0;
+        double servoVelocity = 0.0;
+        double servoError = 0.0; // trajectory minus position
+        double servoTime = 0.0;  // s, integrated up to
+
+        double faultTime = -1.0; // s, when the current move trips the axis, -1 = never
+        bool ampEnabled = true;
+    };
+
+    struct SimLanding
+    {
+        double time = -1.0; // s, -1 = slot free
+        double position = 0.0;
+    };
+
+    bool Faulted(AxisID axis);
+    IoError Fail(IoError error, AxisID axis, const char *message);
+    void ReleaseCar(double releaseTime, uint32_t release);
+    void ResolveLandings(double now);
+    double Reference(AxisID axis, double time);
+    double Position(AxisID axis);
+    void TrackServo(AxisID axis, double now);
+
+    SimAxis axes[AXIS_COUNT];
+    double sensorEdge[2] = {-1.0, -1.0}; // s, rising edge of each beam, -1 = no car
+    double occlusion = 0.0;              // s the car takes to pass a beam
+    SimLanding landings[SIM_MAX_LANDINGS];
+    uint32_t nextLanding = 0;
+    double impactTime = -1.0;            // s, last car to land in the catcher, -1 = none
+    uint32_t rampMoves = 0;              // a car only drops for the latest ramp move
+    bool servoModel;
+    std::mt19937 rng;
+    char errorDetail[64] = "";
+};
+
+// Runs a simulated launch session through the normal launch pipeline and
+// prints throughput and timing. virtualTime = false paces it in real time.
+// autoAngle launches the recommended angle (see angle_recommender.h) once the
+// simulated history covers enough angles, cycling SIM_ANGLES until then.
+// faultRate > 0 injects axis faults for the fault supervisor to recover.
+int RunSimulation(int launches, bool virtualTime, bool autoAngle = false, double faultRate = 0.0);
+
+// Runs the profile tuner (profile_tuner.h) against the servo model on a
+// virtual clock; axis -1 = all.
+int RunTuningSimulation(int axis, const char *applyPath);
+
+// Runs 1, 2, 4, ... maxRigs simulated rigs side by side, each on its own pinned
+// thread and virtual clock, and prints how launch throughput scales.
+int RunRigBenchmark(int maxRigs, int launchesPerRig);
@@ -0,0 +1,105 @@
+#include "span_trace.h"
+
+#ifdef HOTWHEELS_TRACE_SPANS
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    constexpr uint32_t SPAN_BUFFER_CAPACITY = 1 << 16; // spans per thread; later spans are dropped
+
+    struct SpanEvent
+    {
+        const char *name;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    // Written only by its owning thread; `count` is published with release so the
+    // exporter can read completed events from another thread.
+    struct SpanBuffer
+    {
+        uint32_t tid = 0;
+        atomic<uint32_t> count{0};
+        uint64_t dropped = 0;
+        SpanEvent events[SPAN_BUFFER_CAPACITY];
+    };
+
+    mutex gBuffersMutex;
+    vector<SpanBuffer *> gBuffers; // never freed: spans outlive their threads
+
+    // Tick/time pair taken at startup; the exporter takes a second one to derive the tick rate.
+    const uint64_t gStartTicks = SpanTicks();
+    const auto gStartTime = chrono::steady_clock::now();
+
+    SpanBuffer *RegisterBuffer()
+    {
+        SpanBuffer *buffer = new SpanBuffer;
+        lock_guard<mutex> lock(gBuffersMutex);
+        buffer->tid = static_cast<uint32_t>(gBuffers.size() + 1);
+        gBuffers.push_back(buffer);
+        return buffer;
+    }
+
+    thread_local SpanBuffer *tBuffer = nullptr;
+}
+
+void SpanRecord(const char *name, uint64_t start, uint64_t end)
+{
+    if (!tBuffer)
+        tBuffer = RegisterBuffer();
+    uint32_t index = tBuffer->count.load(memory_order_relaxed);
+    if (index >= SPAN_BUFFER_CAPACITY)
+    {
+        tBuffer->dropped++;
+        return;
+    }
+    tBuffer->events[index] = {name, start, end};
+    tBuffer->count.store(index + 1, memory_order_release);
+}
+
+bool SpanTraceExport(const char *path)
+{
+    uint64_t endTicks = SpanTicks();
+    double elapsedUs = chrono::duration<double, micro>(chrono::steady_clock::now() - gStartTime).count();
+    double ticksPerUs = (elapsedUs > 0.0) ? (endTicks - gStartTicks) / elapsedUs : 1.0;
+
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        cerr << "[Spans] Could not open " << path << endl;
+        return false;
+    }
+
+    lock_guard<mutex> lock(gBuffersMutex);
+    size_t total = 0;
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    for (const SpanBuffer *buffer : gBuffers)
+    {
+        uint32_t count = buffer->count.load(memory_order_acquire);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const SpanEvent &event = buffer->events[i];
+            fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    total ? "," : "", event.name, buffer->tid,
+                    static_cast<double>(event.start - gStartTicks) / ticksPerUs,
+                    static_cast<double>(event.end - event.start) / ticksPerUs);
+            total++;
+        }
+        if (buffer->dropped)
+            cerr << "[Spans] Thread " << buffer->tid << " dropped " << buffer->dropped << " spans (buffer full).\n";
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    cout << "[Spans] Wrote " << total << " spans to " << path << "\n";
+    return true;
+}
+
+#endif
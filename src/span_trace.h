@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+
+// === PHASE SPANS ===
+// Scoped, TSC-stamped spans recorded into per-thread buffers and exported as
+// Chrome trace-event JSON (load in chrome://tracing or ui.perfetto.dev).
+// Built only with -DHOTWHEELS_TRACE_SPANS; otherwise TRACE_SPAN() expands to
+// nothing and SpanTraceExport() is an inline no-op.
+//
+//   TRACE_SPAN("sensor1_wait");   // span lasts until the end of the scope
+//
+// Span names must be string literals (or otherwise outlive the export).
+
+#define TRACE_SPAN_CONCAT2(a, b) a##b
+#define TRACE_SPAN_CONCAT(a, b) TRACE_SPAN_CONCAT2(a, b)
+
+#ifdef HOTWHEELS_TRACE_SPANS
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+inline uint64_t SpanTicks() { return __rdtsc(); }
+#else
+#include <ctime>
+inline uint64_t SpanTicks()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+#endif
+
+void SpanRecord(const char *name, uint64_t start, uint64_t end);
+
+class SpanScope
+{
+public:
+    explicit SpanScope(const char *name) : name(name), start(SpanTicks()) {}
+    ~SpanScope() { SpanRecord(name, start, SpanTicks()); }
+    SpanScope(const SpanScope &) = delete;
+    SpanScope &operator=(const SpanScope &) = delete;
+
+private:
+    const char *name;
+    uint64_t start;
+};
+
+#define TRACE_SPAN(name) SpanScope TRACE_SPAN_CONCAT(traceSpan, __LINE__)(name)
+
+// Writes every span recorded so far, from all threads. Returns false if the
+// file could not be written.
+bool SpanTraceExport(const char *path);
+
+#else
+
+#define TRACE_SPAN(name) ((void)0)
+inline bool SpanTraceExport(const char *) { return false; }
+
+#endif
@@ -0,0 +1,67 @@
+#include "status_block.h"
+#include <algorithm>
+
+using namespace std;
+
+int StatusBlock::Add(uint64_t address, uint32_t bytes)
+{
+    for (int f = 0; f < fieldCount; f++)
+    {
+        if (fields[f].address == address && fields[f].bytes == bytes)
+            return f;
+    }
+    if (fieldCount == STATUS_MAX_FIELDS || bytes == 0 || bytes > STATUS_BUFFER_BYTES)
+        return -1;
+    fields[fieldCount].address = address;
+    fields[fieldCount].bytes = bytes;
+    return fieldCount++;
+}
+
+bool StatusBlock::Plan()
+{
+    spanCount = 0;
+    if (fieldCount == 0)
+        return true;
+
+    int order[STATUS_MAX_FIELDS];
+    for (int f = 0; f < fieldCount; f++)
+        order[f] = f;
+    sort(order, order + fieldCount, [this](int a, int b) { return fields[a].address < fields[b].address; });
+
+    uint32_t used = 0;
+    Span *span = nullptr;
+    for (int i = 0; i < fieldCount; i++)
+    {
+        Field &field = fields[order[i]];
+        uint64_t spanEnd = span ? span->address + span->bytes : 0;
+        if (!span || field.address > spanEnd + STATUS_SPAN_GAP_BYTES)
+        {
+            if (spanCount == STATUS_MAX_SPANS)
+                return false;
+            span = &spans[spanCount++];
+            span->address = field.address;
+            span->bytes = 0;
+            span->offset = used;
+            spanEnd = field.address;
+        }
+        uint64_t fieldEnd = field.address + field.bytes;
+        if (fieldEnd > spanEnd)
+        {
+            uint32_t growth = static_cast<uint32_t>(fieldEnd - spanEnd);
+            if (used + growth > STATUS_BUFFER_BYTES)
+                return false;
+            used += growth;
+            span->bytes += growth;
+        }
+        field.offset = span->offset + static_cast<uint32_t>(field.address - span->address);
+    }
+    return true;
+}
+
+uint32_t StatusBlock::TotalBytes() const
+{
+    uint32_t total = 0;
+    for (int s = 0; s < spanCount; s++)
+        total += spans[s].bytes;
+    return total;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// === STATUS BLOCK ===
+// Batches reads of controller memory. The fields a control cycle needs (input
+// words, axis positions, the sample counter) are registered once at setup;
+// Plan() sorts them by address and merges neighbours into as few contiguous
+// spans as the buffer allows, so a cycle costs one block read per span
+// (usually one) instead of one SDK call per value. Reading and decoding touch
+// only the fixed buffer: no allocation, safe on the hot path.
+
+constexpr int STATUS_MAX_FIELDS = 16;
+constexpr int STATUS_MAX_SPANS = 4;
+constexpr uint32_t STATUS_BUFFER_BYTES = 4096;
+constexpr uint32_t STATUS_SPAN_GAP_BYTES = 512; // read across gaps up to this size rather than start a new span
+
+class StatusBlock
+{
+public:
+    // Setup only. Returns the field id, -1 when full. Registering the same
+    // address and size twice returns the first id.
+    int Add(uint64_t address, uint32_t bytes);
+
+    // Groups the fields into spans; false if they do not fit in
+    // STATUS_MAX_SPANS spans of STATUS_BUFFER_BYTES in total.
+    bool Plan();
+
+    int SpanCount() const { return spanCount; }
+    uint64_t SpanAddress(int span) const { return spans[span].address; }
+    uint32_t SpanBytes(int span) const { return spans[span].bytes; }
+    uint8_t *SpanData(int span) { return buffer + spans[span].offset; }
+    uint32_t TotalBytes() const;
+
+    // Value of a field as of the last read of its span.
+    template <typename T>
+    T Get(int field) const
+    {
+        T value;
+        memcpy(&value, buffer + fields[field].offset, sizeof(T));
+        return value;
+    }
+
+private:
+    struct Field
+    {
+        uint64_t address = 0;
+        uint32_t bytes = 0;
+        uint32_t offset = 0; // into buffer, set by Plan()
+    };
+    struct Span
+    {
+        uint64_t address = 0;
+        uint32_t bytes = 0;
+        uint32_t offset = 0;
+    };
+
+    Field fields[STATUS_MAX_FIELDS];
+    int fieldCount = 0;
+    Span spans[STATUS_MAX_SPANS];
+    int spanCount = 0;
+    alignas(8) uint8_t buffer[STATUS_BUFFER_BYTES] = {};
+};
@@ -0,0 +1,278 @@
+#include "stream_stats.h"
+#include "launch_pipeline.h"
+#include "varint.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+using namespace std;
+
+namespace
+{
+    constexpr uint32_t STATS_MAGIC = 0x53535748; // "HWSS"
+    constexpr uint32_t STATS_VERSION = 1;
+
+    const double SKETCH_GAMMA = (1.0 + SKETCH_ACCURACY) / (1.0 - SKETCH_ACCURACY);
+    const double SKETCH_LOG_GAMMA = log(SKETCH_GAMMA);
+    const int SKETCH_MIN_INDEX = static_cast<int>(ceil(log(SKETCH_MIN_VALUE) / SKETCH_LOG_GAMMA));
+
+    void PutDouble(vector<uint8_t> &out, double value)
+    {
+        PutBytes(out, &value, sizeof(value));
+    }
+
+    void PutStore(vector<uint8_t> &out, const uint32_t *buckets)
+    {
+        int used = 0;
+        for (int i = 0; i < SKETCH_BUCKETS; i++)
+            used += buckets[i] ? 1 : 0;
+        PutVarint(out, used);
+        int previous = 0;
+        for (int i = 0; i < SKETCH_BUCKETS; i++)
+        {
+            if (!buckets[i])
+                continue;
+            PutVarint(out, i - previous);
+            PutVarint(out, buckets[i]);
+            previous = i;
+        }
+    }
+
+    bool GetStore(const uint8_t *in, size_t size, size_t &pos, uint32_t *buckets, uint64_t &total)
+    {
+        int64_t used = 0, index = 0;
+        if (!GetVarint(in, size, pos, used) || used < 0 || used > SKETCH_BUCKETS)
+            return false;
+        for (int64_t i = 0; i < used; i++)
+        {
+            int64_t delta = 0, bucketCount = 0;
+            if (!GetVarint(in, size, pos, delta) || !GetVarint(in, size, pos, bucketCount))
+                return false;
+            index += delta;
+            if (index < 0 || index >= SKETCH_BUCKETS || bucketCount <= 0 || bucketCount > UINT32_MAX)
+                return false;
+            buckets[index] = static_cast<uint32_t>(bucketCount);
+            total += bucketCount;
+        }
+        return true;
+    }
+
+    void PrintRow(const char *name, const StreamStat &stat, double scale)
+    {
+        if (!stat.moments.Count())
+            return;
+        printf("%-22s %8llu %11.3f %11.3f %11.3f %11.3f %11.3f\n", name, (unsigned long long)stat.moments.Count(),
+               stat.moments.Mean() * scale, stat.moments.StdDev() * scale, stat.Quantile(0.5) * scale,
+               stat.Quantile(0.99) * scale, stat.moments.Max() * scale);
+    }
+}
+
+// === RUNNING STATS ===
+void RunningStats::Add(double x)
+{
+    count++;
+    double delta = x - mean;
+    mean += delta / count;
+    m2 += delta * (x - mean);
+    min = (count == 1) ? x : std::min(min, x);
+    max = (count == 1) ? x : std::max(max, x);
+}
+
+void RunningStats::Merge(const RunningStats &other)
+{
+    if (!other.count)
+        return;
+    if (!count)
+    {
+        *this = other;
+        return;
+    }
+    // Chan et al. pairwise combination.
+    uint64_t total = count + other.count;
+    double delta = other.mean - mean;
+    mean += delta * other.count / total;
+    m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / total);
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    count = total;
+}
+
+double RunningStats::StdDev() const
+{
+    return sqrt(Variance());
+}
+
+void RunningStats::Serialize(vector<uint8_t> &out) const
+{
+    PutVarint(out, static_cast<int64_t>(count));
+    PutDouble(out, mean);
+    PutDouble(out, m2);
+    PutDouble(out, min);
+    PutDouble(out, max);
+}
+
+bool RunningStats::Deserialize(const uint8_t *in, size_t size, size_t &pos)
+{
+    int64_t storedCount = 0;
+    if (!GetVarint(in, size, pos, storedCount) || storedCount < 0 || !GetBytes(in, size, pos, &mean, sizeof(mean)) ||
+        !GetBytes(in, size, pos, &m2, sizeof(m2)) || !GetBytes(in, size, pos, &min, sizeof(min)) ||
+        !GetBytes(in, size, pos, &max, sizeof(max)))
+        return false;
+    count = static_cast<uint64_t>(storedCount);
+    return true;
+}
+
+// === QUANTILE SKETCH ===
+int QuantileSketch::BucketIndex(double magnitude)
+{
+    int index = static_cast<int>(ceil(log(magnitude) / SKETCH_LOG_GAMMA)) - SKETCH_MIN_INDEX;
+    return clamp(index, 0, SKETCH_BUCKETS - 1);
+}
+
+double QuantileSketch::BucketValue(int index)
+{
+    // Midpoint (in relative terms) of (gamma^(i-1), gamma^i].
+    return 2.0 * pow(SKETCH_GAMMA, index + SKETCH_MIN_INDEX) / (SKETCH_GAMMA + 1.0);
+}
+
+void QuantileSketch::Add(double x)
+{
+    if (!isfinite(x))
+        return;
+    count++;
+    double magnitude = fabs(x);
+    if (magnitude < SKETCH_MIN_VALUE)
+        zeroCount++;
+    else if (x > 0.0)
+        positive[BucketIndex(magnitude)]++;
+    else
+        negative[BucketIndex(magnitude)]++;
+}
+
+void QuantileSketch::Merge(const QuantileSketch &other)
+{
+    for (int i = 0; i < SKETCH_BUCKETS; i++)
+    {
+        positive[i] += other.positive[i];
+        negative[i] += other.negative[i];
+    }
+    zeroCount += other.zeroCount;
+    count += other.count;
+}
+
+double QuantileSketch::Quantile(double q) const
+{
+    if (!count)
+        return 0.0;
+    double rank = clamp(q, 0.0, 1.0) * (count - 1);
+    uint64_t seen = 0;
+    // Ascending value order: most negative first, then zero, then positive.
+    for (int i = SKETCH_BUCKETS - 1; i >= 0; i--)
+    {
+        seen += negative[i];
+        if (seen > rank)
+            return -BucketValue(i);
+    }
+    seen += zeroCount;
+    if (seen > rank)
+        return 0.0;
+    for (int i = 0; i < SKETCH_BUCKETS; i++)
+    {
+        seen += positive[i];
+        if (seen > rank)
+            return BucketValue(i);
+    }
+    return BucketValue(SKETCH_BUCKETS - 1);
+}
+
+void QuantileSketch::Serialize(vector<uint8_t> &out) const
+{
+    PutVarint(out, static_cast<int64_t>(zeroCount));
+    PutStore(out, positive);
+    PutStore(out, negative);
+}
+
+bool QuantileSketch::Deserialize(const uint8_t *in, size_t size, size_t &pos)
+{
+    *this = QuantileSketch{};
+    int64_t zeros = 0;
+    if (!GetVarint(in, size, pos, zeros) || zeros < 0)
+        return false;
+    zeroCount = static_cast<uint64_t>(zeros);
+    count = zeroCount;
+    return GetStore(in, size, pos, positive, count) && GetStore(in, size, pos, negative, count);
+}
+
+// === LAUNCH STATISTICS ===
+void LaunchStatistics::Add(const LaunchRecord &record)
+{
+    commandLatency.Add(record.catcherCmd);
+    if (record.catcherSettle > 0.0)
+        settleTime.Add(record.catcherSettle);
+    if (record.outcome == CATCH_CAUGHT)
+        landingError.Add(record.impactPosition - record.landing);
+    int bin = clamp(static_cast<int>(record.angle / SPEED_ANGLE_BIN), 0, SPEED_ANGLE_BINS - 1);
+    speedByAngle[bin].Add(record.speed);
+}
+
+void LaunchStatistics::Merge(const LaunchStatistics &other)
+{
+    commandLatency.Merge(other.commandLatency);
+    landingError.Merge(other.landingError);
+    settleTime.Merge(other.settleTime);
+    for (int bin = 0; bin < SPEED_ANGLE_BINS; bin++)
+        speedByAngle[bin].Merge(other.speedByAngle[bin]);
+}
+
+void LaunchStatistics::Serialize(vector<uint8_t> &out) const
+{
+    PutBytes(out, &STATS_MAGIC, sizeof(STATS_MAGIC));
+    PutVarint(out, STATS_VERSION);
+    PutDouble(out, SKETCH_ACCURACY);
+    auto put = [&out](const StreamStat &stat) {
+        stat.moments.Serialize(out);
+        stat.sketch.Serialize(out);
+    };
+    put(commandLatency);
+    put(landingError);
+    put(settleTime);
+    for (const StreamStat &stat : speedByAngle)
+        put(stat);
+}
+
+bool LaunchStatistics::Deserialize(const uint8_t *in, size_t size)
+{
+    size_t pos = 0;
+    uint32_t magic = 0;
+    int64_t version = 0;
+    double accuracy = 0.0;
+    if (!GetBytes(in, size, pos, &magic, sizeof(magic)) || magic != STATS_MAGIC ||
+        !GetVarint(in, size, pos, version) || version != STATS_VERSION ||
+        !GetBytes(in, size, pos, &accuracy, sizeof(accuracy)) || accuracy != SKETCH_ACCURACY)
+        return false;
+    auto get = [&](StreamStat &stat) {
+        return stat.moments.Deserialize(in, size, pos) && stat.sketch.Deserialize(in, size, pos);
+    };
+    if (!get(commandLatency) || !get(landingError) || !get(settleTime))
+        return false;
+    for (StreamStat &stat : speedByAngle)
+    {
+        if (!get(stat))
+            return false;
+    }
+    return true;
+}
+
+void LaunchStatistics::Print() const
+{
+    printf("%-22s %8s %11s %11s %11s %11s %11s\n", "statistic", "count", "mean", "stddev", "p50", "p99", "max");
+    PrintRow("command latency (ms)", commandLatency, 1000.0);
+    PrintRow("landing error (mm)", landingError, 1000.0);
+    PrintRow("settle time (ms)", settleTime, 1000.0);
+    for (int bin = 0; bin < SPEED_ANGLE_BINS; bin++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "speed %2.0f-%2.0f deg (m/s)", bin * SPEED_ANGLE_BIN, (bin + 1) * SPEED_ANGLE_BIN);
+        PrintRow(name, speedByAngle[bin], 1.0);
+    }
+}
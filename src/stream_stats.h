@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// === STREAMING STATISTICS ===
+// Constant-memory running statistics for unattended sessions. RunningStats
+// keeps Welford mean/variance plus min/max; QuantileSketch is a DDSketch with
+// fixed log buckets, so any quantile comes back within SKETCH_ACCURACY of the
+// true value (relative). Both merge exactly, so per-thread copies can be
+// combined at any time, and both serialize into a compact varint blob.
+
+constexpr double SKETCH_ACCURACY = 0.01;   // relative error of Quantile()
+constexpr double SKETCH_MIN_VALUE = 1e-6;  // |x| below this counts as zero
+constexpr double SKETCH_MAX_VALUE = 1e4;   // |x| above this lands in the top bucket
+constexpr int SKETCH_BUCKETS = 1153;       // ceil(log(MAX / MIN) / log(gamma)) + 1
+
+class RunningStats
+{
+public:
+    void Add(double x);
+    void Merge(const RunningStats &other);
+
+    uint64_t Count() const { return count; }
+    double Mean() const { return mean; }
+    double Variance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+    double StdDev() const;
+    double Min() const { return min; }
+    double Max() const { return max; }
+
+    void Serialize(std::vector<uint8_t> &out) const;
+    bool Deserialize(const uint8_t *in, size_t size, size_t &pos);
+
+private:
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0; // sum of squared deviations from the mean
+    double min = 0.0;
+    double max = 0.0;
+};
+
+class QuantileSketch
+{
+public:
+    void Add(double x);
+    void Merge(const QuantileSketch &other);
+
+    uint64_t Count() const { return count; }
+    double Quantile(double q) const; // q in [0, 1]; 0 when empty
+
+    // Only non-empty buckets are written.
+    void Serialize(std::vector<uint8_t> &out) const;
+    bool Deserialize(const uint8_t *in, size_t size, size_t &pos);
+
+private:
+    static int BucketIndex(double magnitude);
+    static double BucketValue(int index);
+
+    uint32_t positive[SKETCH_BUCKETS] = {};
+    uint32_t negative[SKETCH_BUCKETS] = {};
+    uint64_t zeroCount = 0;
+    uint64_t count = 0;
+};
+
+// One tracked quantity: moments and quantiles together.
+struct StreamStat
+{
+    RunningStats moments;
+    QuantileSketch sketch;
+
+    void Add(double x)
+    {
+        moments.Add(x);
+        sketch.Add(x);
+    }
+    void Merge(const StreamStat &other)
+    {
+        moments.Merge(other.moments);
+        sketch.Merge(other.sketch);
+    }
+    // Sketch estimate, clamped to the exact observed range.
+    double Quantile(double q) const
+    {
+        return std::clamp(sketch.Quantile(q), moments.Min(), moments.Max());
+    }
+};
+
+// === LAUNCH STATISTICS ===
+constexpr double SPEED_ANGLE_BIN = 5.0; // deg per speed sketch
+constexpr int SPEED_ANGLE_BINS = 18;    // 0..90 deg
+
+struct LaunchRecord;
+
+struct LaunchStatistics
+{
+    StreamStat commandLatency;                 // s, sensor 2 edge to catcher command (LaunchRecord::catcherCmd)
+    StreamStat landingError;                   // m, detected impact minus predicted landing, caught cars only
+    StreamStat settleTime;                     // s, catcher command to motion done
+    StreamStat speedByAngle[SPEED_ANGLE_BINS]; // m/s, by ramp angle
+
+    void Add(const LaunchRecord &record); // completed launches only
+    void Merge(const LaunchStatistics &other);
+
+    // Appends to `out` (reuse one buffer to avoid reallocating).
+    void Serialize(std::vector<uint8_t> &out) const;
+    bool Deserialize(const uint8_t *in, size_t size);
+
+    void Print() const; // count, mean, stddev, p50, p99, max per quantity
+};
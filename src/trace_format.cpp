@@ -0,0 +1,150 @@
+#include "trace_format.h"
+#include "varint.h"
+#include <cstring>
+
+using namespace std;
+
+bool TraceWriter::Open(const string &path, const TraceHeader &header)
+{
+    Close();
+    file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    uint16_t channelCount = static_cast<uint16_t>(header.channels.size());
+    PutBytes(buffer, "HWTR", 4);
+    PutBytes(buffer, &TRACE_VERSION, sizeof(TRACE_VERSION));
+    PutBytes(buffer, &channelCount, sizeof(channelCount));
+    PutBytes(buffer, &header.sampleRate, sizeof(header.sampleRate));
+    for (const TraceChannel &channel : header.channels)
+    {
+        PutBytes(buffer, &channel.kind, 1);
+        PutBytes(buffer, &channel.axis, 1);
+        PutBytes(buffer, &channel.countsPerUnit, sizeof(channel.countsPerUnit));
+    }
+    previous.assign(channelCount, 0);
+    Flush();
+    return true;
+}
+
+void TraceWriter::BeginWindow(uint32_t launchId)
+{
+    if (!file || inWindow)
+        return;
+    buffer.push_back('W');
+    PutBytes(buffer, &launchId, sizeof(launchId));
+    fill(previous.begin(), previous.end(), 0);
+    windowRecords = 0;
+    inWindow = true;
+}
+
+void TraceWriter::WriteRecord(const int64_t *values)
+{
+    if (!inWindow)
+        return;
+    for (size_t i = 0; i < previous.size(); i++)
+    {
+        PutVarint(buffer, values[i] - previous[i]);
+        previous[i] = values[i];
+    }
+    windowRecords++;
+    if (buffer.size() >= 64 * 1024)
+        Flush();
+}
+
+void TraceWriter::EndWindow()
+{
+    if (!inWindow)
+        return;
+    buffer.push_back(0x00);
+    PutBytes(buffer, &windowRecords, sizeof(windowRecords));
+    inWindow = false;
+    Flush();
+}
+
+void TraceWriter::Close()
+{
+    if (!file)
+        return;
+    EndWindow();
+    Flush();
+    fclose(file);
+    file = nullptr;
+}
+
+void TraceWriter::Flush()
+{
+    if (file && !buffer.empty())
+    {
+        bytesWritten += fwrite(buffer.data(), 1, buffer.size(), file);
+        fflush(file);
+    }
+    buffer.clear();
+}
+
+// === READER ===
+bool TraceRead(const string &path, TraceHeader &header, vector<TraceWindow> &windows)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    vector<uint8_t> in;
+    uint8_t chunk[64 * 1024];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        in.insert(in.end(), chunk, chunk + n);
+    fclose(file);
+
+    size_t pos = 0;
+    char magic[4];
+    uint16_t version = 0, channelCount = 0;
+    if (!GetBytes(in, pos, magic, 4) || memcmp(magic, "HWTR", 4) != 0 ||
+        !GetBytes(in, pos, &version, sizeof(version)) || version != TRACE_VERSION ||
+        !GetBytes(in, pos, &channelCount, sizeof(channelCount)) || channelCount == 0 ||
+        !GetBytes(in, pos, &header.sampleRate, sizeof(header.sampleRate)))
+        return false;
+
+    header.channels.assign(channelCount, TraceChannel{});
+    for (TraceChannel &channel : header.channels)
+    {
+        if (!GetBytes(in, pos, &channel.kind, 1) || !GetBytes(in, pos, &channel.axis, 1) ||
+            !GetBytes(in, pos, &channel.countsPerUnit, sizeof(channel.countsPerUnit)))
+            return false;
+    }
+
+    vector<int64_t> previous(channelCount);
+    while (pos < in.size())
+    {
+        if (in[pos++] != 'W')
+            return false;
+        TraceWindow window;
+        if (!GetBytes(in, pos, &window.launchId, sizeof(window.launchId)))
+            return false;
+        fill(previous.begin(), previous.end(), 0);
+
+        while (true)
+        {
+            if (pos >= in.size())
+                return false; // window was never closed (e.g. crash mid-capture)
+            if (in[pos] == 0x00)
+            {
+                pos++;
+                uint32_t recordCount = 0;
+                if (!GetBytes(in, pos, &recordCount, sizeof(recordCount)) ||
+                    recordCount != window.RecordCount(channelCount))
+                    return false;
+                break;
+            }
+            for (uint16_t i = 0; i < channelCount; i++)
+            {
+                int64_t delta;
+                if (!GetVarint(in, pos, delta))
+                    return false;
+                previous[i] += delta;
+                window.values.push_back(previous[i]);
+            }
+        }
+        windows.push_back(move(window));
+    }
+    return true;
+}
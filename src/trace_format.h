@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// === TRACE FILE FORMAT ===
+// Header: "HWTR" | u16 version | u16 channelCount | f64 sampleRate
+//         then per channel: u8 kind | u8 axis | f64 countsPerUnit
+// Window: 'W' | u32 launchId | records... | 0x00 | u32 recordCount
+// Record: one zigzag varint per channel, delta against the previous record in
+//         the same window (the first record is delta against zero). Channel 0 is
+//         always the sample counter, whose delta is never zero, so a lone 0x00
+//         where a record would start marks the end of the window.
+
+constexpr uint16_t TRACE_VERSION = 1;
+
+enum TraceChannelKind : uint8_t
+{
+    TRACE_SAMPLE = 0,
+    TRACE_COMMAND_POSITION = 1,
+    TRACE_ACTUAL_POSITION = 2,
+    TRACE_POSITION_ERROR = 3,
+    TRACE_SENSORS = 4 // bit 0 = sensor 1, bit 1 = sensor 2
+};
+
+struct TraceChannel
+{
+    uint8_t kind = TRACE_SAMPLE;
+    uint8_t axis = 0;
+    double countsPerUnit = 1.0; // divide a recorded value by this for user units
+};
+
+struct TraceHeader
+{
+    double sampleRate = 0.0;
+    std::vector<TraceChannel> channels;
+};
+
+struct TraceWindow
+{
+    uint32_t launchId = 0;
+    std::vector<int64_t> values; // recordCount rows of channels.size() values
+
+    size_t RecordCount(size_t channelCount) const { return channelCount ? values.size() / channelCount : 0; }
+};
+
+class TraceWriter
+{
+public:
+    ~TraceWriter() { Close(); }
+
+    bool Open(const std::string &path, const TraceHeader &header);
+    void BeginWindow(uint32_t launchId);
+    void WriteRecord(const int64_t *values);
+    void EndWindow();
+    void Close();
+
+    bool IsOpen() const { return file != nullptr; }
+    bool InWindow() const { return inWindow; }
+    uint64_t BytesWritten() const { return bytesWritten; }
+
+private:
+    void Flush();
+
+    FILE *file = nullptr;
+    std::vector<int64_t> previous;
+    std::vector<uint8_t> buffer;
+    uint32_t windowRecords = 0;
+    uint64_t bytesWritten = 0;
+    bool inWindow = false;
+};
+
+// Reads a whole trace file. Returns false on a missing file or a corrupt stream;
+// windows decoded before the corruption are kept.
+bool TraceRead(const std::string &path, TraceHeader &header, std::vector<TraceWindow> &windows);
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// === ENCODING HELPERS ===
+// Raw bytes and zigzag LEB128 varints, shared by the trace format and the
+// statistics blobs. Readers advance `pos` and return false on truncated input.
+
+inline void PutBytes(std::vector<uint8_t> &out, const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+inline void PutVarint(std::vector<uint8_t> &out, int64_t value)
+{
+    uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    while (zigzag >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(zigzag) | 0x80);
+        zigzag >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(zigzag));
+}
+
+inline bool GetBytes(const uint8_t *in, size_t size, size_t &pos, void *data, size_t count)
+{
+    if (pos + count > size)
+        return false;
+    memcpy(data, in + pos, count);
+    pos += count;
+    return true;
+}
+
+inline bool GetVarint(const uint8_t *in, size_t size, size_t &pos, int64_t &value)
+{
+    uint64_t zigzag = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (pos >= size)
+            return false;
+        uint8_t byte = in[pos++];
+        zigzag |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            value = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool GetBytes(const std::vector<uint8_t> &in, size_t &pos, void *data, size_t count)
+{
+    return GetBytes(in.data(), in.size(), pos, data, count);
+}
+
+inline bool GetVarint(const std::vector<uint8_t> &in, size_t &pos, int64_t &value)
+{
+    return GetVarint(in.data(), in.size(), pos, value);
+}